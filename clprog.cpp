@@ -18,6 +18,12 @@
 #include <cstdint>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <thread>
 
 #define CL_CALL(call)                                                               \
     do {                                                                            \
@@ -48,12 +54,202 @@ static std::string getPlatform(cl_platform_id id) {
     return std::string(buf.data(), buf.data() + len - 1);
 }
 
+// GPU devices of the platform; platforms without GPUs (POCL, Intel CPU runtime) expose their CPU
+// or accelerator devices instead.
+static std::vector<cl_device_id> platformDevices(cl_platform_id platformId) {
+    const cl_device_type types[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ALL};
+    for (cl_device_type type : types) {
+        cl_uint count = 0;
+        if (clGetDeviceIDs(platformId, type, 0, nullptr, &count) == CL_SUCCESS && count > 0) {
+            std::vector<cl_device_id> devices(count);
+            if (clGetDeviceIDs(platformId, type, count, devices.data(), nullptr) == CL_SUCCESS) {
+                return devices;
+            }
+        }
+    }
+    return {};
+}
+
+static bool loadKernelSource(std::string& source) {
+    std::ifstream kernelFile("kernel.cl");
+    std::ifstream keccakFile("utils/keccak.cl");
+    if (!kernelFile.is_open() || !keccakFile.is_open()) {
+        std::cerr << "Failed to load OpenCL kernel files." << std::endl;
+        return false;
+    }
+    std::string kernelSource((std::istreambuf_iterator<char>(kernelFile)), std::istreambuf_iterator<char>());
+    std::string keccakSource((std::istreambuf_iterator<char>(keccakFile)), std::istreambuf_iterator<char>());
+    source = keccakSource + "\n" + kernelSource;
+    return true;
+}
+
+static std::string kernelBuildOptions(int dataSize, int nonceOffset, int difficulty) {
+    std::string buildOptions = "-D CL_TARGET_OPENCL_VERSION=" + std::to_string(CL_TARGET_OPENCL_VERSION);
+    if (dataSize == 76 && nonceOffset == 4) {
+        buildOptions += " -D DATA_SIZE=76 -D NONCE_OFFSET=4";
+    }
+    if (difficulty >= 1 && difficulty <= 16) {
+        buildOptions += " -D DIFFICULTY=" + std::to_string(difficulty);
+    }
+    return buildOptions;
+}
+
+static void printBuildLog(cl_program program, cl_device_id device) {
+    size_t logSize;
+    clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &logSize);
+    std::vector<char> buildLog(logSize);
+    clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, logSize, buildLog.data(), NULL);
+    std::cerr << "Kernel build error: " << std::endl << buildLog.data() << std::endl;
+}
+
+// Device fission for CPU devices: one sub-device per NUMA node or shared cache (the first
+// partitionable affinity level). Empty when the device is not a CPU or does not partition.
+static std::vector<cl_device_id> affinitySubDevices(cl_device_id device) {
+    cl_device_type type = 0;
+    cl_device_affinity_domain domains = 0;
+    if (clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, nullptr) != CL_SUCCESS || !(type & CL_DEVICE_TYPE_CPU)
+        || clGetDeviceInfo(device, CL_DEVICE_PARTITION_AFFINITY_DOMAIN, sizeof(domains), &domains, nullptr) != CL_SUCCESS
+        || !(domains & CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE)) {
+        return {};
+    }
+    const cl_device_partition_property properties[] = {
+        CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN, CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE, 0
+    };
+    cl_uint count = 0;
+    if (clCreateSubDevices(device, properties, 0, nullptr, &count) != CL_SUCCESS || count < 2) {
+        return {};
+    }
+    std::vector<cl_device_id> subDevices(count);
+    if (clCreateSubDevices(device, properties, count, subDevices.data(), nullptr) != CL_SUCCESS) {
+        return {};
+    }
+    return subDevices;
+}
+
+// One context over the sub-devices. Each sub-device gets its own queue, kernel and result buffers
+// and a host thread pulling nonce chunks from a shared counter until the batch is done or a
+// sub-device finds a solution. With showDeviceInfo (first batch of a verbose run) prints the
+// throughput of every sub-device; stdout carries the result JSON, so not on every batch.
+static int executeSubDevices(const std::vector<cl_device_id>& subDevices, std::uint8_t* data, int dataSize, std::uint64_t startNonce,
+    int nonceOffset, std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce,
+    bool showDeviceInfo) {
+    static const std::uint64_t chunksPerDevice = 8;
+    cl_int error;
+    cl_uint count = static_cast<cl_uint>(subDevices.size());
+    cl_context context = clCreateContext(nullptr, count, subDevices.data(), nullptr, nullptr, &error);
+    if (!context) {
+        std::cerr << "Error: " << error << std::endl;
+        return -1;
+    }
+    std::string source;
+    if (!loadKernelSource(source)) {
+        releaseResources(context, nullptr, nullptr, nullptr, nullptr, 0);
+        return -1;
+    }
+    const char* sourceStr = source.c_str();
+    size_t sourceSize = source.size();
+    std::string options = kernelBuildOptions(dataSize, nonceOffset, difficulty);
+    cl_program program = clCreateProgramWithSource(context, 1, &sourceStr, &sourceSize, &error);
+    if (!program || clBuildProgram(program, count, subDevices.data(), options.c_str(), nullptr, nullptr) != CL_SUCCESS) {
+        if (program) printBuildLog(program, subDevices[0]);
+        releaseResources(context, nullptr, program, nullptr, nullptr, 0);
+        return -1;
+    }
+
+    std::uint64_t chunk = std::max<std::uint64_t>(1, batchSize / (count * chunksPerDevice));
+    std::atomic<std::uint64_t> next(0);
+    std::atomic<int> winner(-1);
+    std::atomic<bool> failed(false);
+    std::vector<double> rates(count, 0);
+    std::vector<cl_uint> computeUnits(count, 0);
+    std::vector<std::thread> threads;
+    for (cl_uint d = 0; d < count; ++d) {
+        threads.emplace_back([&, d]() {
+            cl_int err;
+            cl_device_id device = subDevices[d];
+            clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_uint), &computeUnits[d], nullptr);
+#if CL_TARGET_OPENCL_VERSION >= 200
+            cl_command_queue queue = clCreateCommandQueueWithProperties(context, device, 0, &err);
+#else
+            cl_command_queue queue = clCreateCommandQueue(context, device, 0, &err);
+#endif
+            cl_kernel kernel = clCreateKernel(program, "run", &err);
+            cl_mem dataBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, dataSize * sizeof(cl_uchar), data, &err);
+            cl_mem foundBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_int), nullptr, &err);
+            cl_mem outputBuffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, 32 * sizeof(cl_uchar), nullptr, &err);
+            cl_mem nonceBuffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, sizeof(cl_ulong), nullptr, &err);
+            cl_mem buffers[] = {dataBuffer, foundBuffer, outputBuffer, nonceBuffer};
+            cl_int found = 0;
+            bool ready = queue && kernel && dataBuffer && foundBuffer && outputBuffer && nonceBuffer
+                && clEnqueueWriteBuffer(queue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &found, 0, nullptr, nullptr) == CL_SUCCESS;
+            size_t maxWorkGroupSize = 1;
+            clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(size_t), &maxWorkGroupSize, nullptr);
+            size_t localWorkSize = std::min(static_cast<size_t>(threadsPerBlock), maxWorkGroupSize);
+            std::uint64_t hashed = 0;
+            auto startTime = std::chrono::high_resolution_clock::now();
+            while (ready && winner.load() < 0 && !failed.load()) {
+                std::uint64_t offset = next.fetch_add(chunk);
+                if (offset >= batchSize) {
+                    break;
+                }
+                std::uint64_t begin = startNonce + offset;
+                std::uint64_t size = std::min(chunk, batchSize - offset);
+                err = clSetKernelArg(kernel, 0, sizeof(cl_int), &dataSize);
+                err |= clSetKernelArg(kernel, 1, sizeof(cl_ulong), &begin);
+                err |= clSetKernelArg(kernel, 2, sizeof(cl_int), &nonceOffset);
+                err |= clSetKernelArg(kernel, 3, sizeof(cl_ulong), &size);
+                err |= clSetKernelArg(kernel, 4, sizeof(cl_int), &difficulty);
+                err |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &dataBuffer);
+                err |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &foundBuffer);
+                err |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &outputBuffer);
+                err |= clSetKernelArg(kernel, 8, sizeof(cl_mem), &nonceBuffer);
+                size_t globalWorkSize = ((size + localWorkSize - 1) / localWorkSize) * localWorkSize;
+                if (err != CL_SUCCESS
+                    || clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &globalWorkSize, &localWorkSize, 0, nullptr, nullptr) != CL_SUCCESS
+                    || clEnqueueReadBuffer(queue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &found, 0, nullptr, nullptr) != CL_SUCCESS) {
+                    failed.store(true);
+                    break;
+                }
+                hashed += size;
+                int none = -1;
+                if (found == 1 && winner.compare_exchange_strong(none, static_cast<int>(d))) {
+                    clEnqueueReadBuffer(queue, outputBuffer, CL_TRUE, 0, 32 * sizeof(cl_uchar), output, 0, nullptr, nullptr);
+                    clEnqueueReadBuffer(queue, nonceBuffer, CL_TRUE, 0, sizeof(cl_ulong), validNonce, 0, nullptr, nullptr);
+                }
+            }
+            if (!ready) {
+                failed.store(true);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            rates[d] = hashed / std::max(elapsed.count(), 1e-9);
+            releaseResources(nullptr, queue, nullptr, kernel, buffers, 4);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (showDeviceInfo) {
+        std::ostringstream report;
+        report << "[GPU] OpenCL sub-devices:";
+        for (cl_uint d = 0; d < count; ++d) {
+            report << (d ? "," : "") << " #" << d << " (" << computeUnits[d] << " CU) "
+                   << std::fixed << std::setprecision(2) << rates[d] / 1e6 << " MH/s";
+        }
+        std::cout << report.str() << std::endl;
+    }
+    releaseResources(context, nullptr, program, nullptr, nullptr, 0);
+    if (failed.load()) {
+        std::cerr << "OpenCL sub-device execution failed." << std::endl;
+        return -1;
+    }
+    return winner.load() >= 0 ? 1 : 0;
+}
+
 extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset, std::uint64_t batchSize,
     int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo) {
     cl_int error;
     cl_platform_id platformId = nullptr;
     cl_device_id selectedDevice = nullptr;
-    cl_uint numDevices;
     cl_uint numPlatforms = 0;
 
     CL_CALL(clGetPlatformIDs(0, nullptr, &numPlatforms));
@@ -70,15 +266,11 @@ extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* d
     }
     platformId = platformIndex != -1 ? platforms[platformIndex] : platforms[0];
 
-    CL_CALL(clGetDeviceIDs(platformId, CL_DEVICE_TYPE_GPU, 0, nullptr, &numDevices));
-
-    if (deviceId >= numDevices) {
+    std::vector<cl_device_id> devices = platformDevices(platformId);
+    if (deviceId < 0 || deviceId >= static_cast<int>(devices.size())) {
         std::cerr << "Invalid device ID" << std::endl;
         return -1;
     }
-
-    std::vector<cl_device_id> devices(numDevices);
-    CL_CALL(clGetDeviceIDs(platformId, CL_DEVICE_TYPE_GPU, numDevices, devices.data(), nullptr));
     selectedDevice = devices[deviceId];
 
     if (showDeviceInfo) {
@@ -104,6 +296,16 @@ extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* d
         std::cout << "Global memory size: " << (globalMemSize / (1024 * 1024)) << " MB" << std::endl;
     }
 
+    std::vector<cl_device_id> subDevices = affinitySubDevices(selectedDevice);
+    if (!subDevices.empty()) {
+        int result = executeSubDevices(subDevices, data, dataSize, startNonce, nonceOffset, batchSize, difficulty, threadsPerBlock,
+            output, validNonce, showDeviceInfo);
+        for (cl_device_id subDevice : subDevices) {
+            clReleaseDevice(subDevice);
+        }
+        return result;
+    }
+
     cl_context context = clCreateContext(nullptr, 1, &selectedDevice, nullptr, nullptr, &error);
     if (!context) {
         std::cerr << "Error: " << error << std::endl;
@@ -120,44 +322,34 @@ extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* d
         return -1;
     }
 
-    std::ifstream kernelFile("kernel.cl");
-    std::ifstream keccakFile("utils/keccak.cl");
-    if (!kernelFile.is_open() || !keccakFile.is_open()) {
-        std::cerr << "Failed to load OpenCL kernel files." << std::endl;
+    std::string fullSource;
+    if (!loadKernelSource(fullSource)) {
         releaseResources(context, commandQueue, nullptr, nullptr, nullptr, 0);
         return -1;
     }
-    std::string kernelSource((std::istreambuf_iterator<char>(kernelFile)), std::istreambuf_iterator<char>());
-    std::string keccakSource((std::istreambuf_iterator<char>(keccakFile)), std::istreambuf_iterator<char>());
-    kernelFile.close();
-    keccakFile.close();
-    std::string fullSource = keccakSource + "\n" + kernelSource;
     const char* sourceStr = fullSource.c_str();
     size_t sourceSize = fullSource.size();
-
-    cl_program program = clCreateProgramWithSource(context, 1, &sourceStr, &sourceSize, &error);
-    if (!program) {
-        std::cerr << "Error: " << error << std::endl;
-        releaseResources(context, commandQueue, program, nullptr, nullptr, 0);
-        return -1;
-    }
-    std::string buildOptions = "-D CL_TARGET_OPENCL_VERSION=" + std::to_string(CL_TARGET_OPENCL_VERSION);
-    error = clBuildProgram(program, 1, &selectedDevice, buildOptions.c_str(), nullptr, nullptr);
-    if (error != CL_SUCCESS) {
-        size_t logSize;
-        clGetProgramBuildInfo(program, selectedDevice, CL_PROGRAM_BUILD_LOG, 0, NULL, &logSize);
-        std::vector<char> buildLog(logSize);
-        clGetProgramBuildInfo(program, selectedDevice, CL_PROGRAM_BUILD_LOG, logSize, buildLog.data(), NULL);
-        std::cerr << "Kernel build error: " << std::endl << buildLog.data() << std::endl;
-        releaseResources(context, commandQueue, program, nullptr, nullptr, 0);
-        return -1;
-    }
-    cl_kernel kernel = clCreateKernel(program, "run", &error);
-    if (!kernel || error != CL_SUCCESS) {
-        std::cerr << "Error: " << error << std::endl;
-        releaseResources(context, commandQueue, program, kernel, nullptr, 0);
-        return -1;
-    }
+    std::string buildOptions = kernelBuildOptions(dataSize, nonceOffset, difficulty);
+    auto buildKernel = [&](int ilp, cl_program& program, cl_kernel& kernel) {
+        program = clCreateProgramWithSource(context, 1, &sourceStr, &sourceSize, &error);
+        kernel = nullptr;
+        if (!program) {
+            std::cerr << "Error: " << error << std::endl;
+            return false;
+        }
+        std::string options = buildOptions + (ilp > 1 ? " -D ILP=" + std::to_string(ilp) : "");
+        error = clBuildProgram(program, 1, &selectedDevice, options.c_str(), nullptr, nullptr);
+        if (error != CL_SUCCESS) {
+            printBuildLog(program, selectedDevice);
+            return false;
+        }
+        kernel = clCreateKernel(program, "run", &error);
+        if (!kernel || error != CL_SUCCESS) {
+            std::cerr << "Error: " << error << std::endl;
+            return false;
+        }
+        return true;
+    };
 
     cl_mem deviceDataBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, dataSize * sizeof(cl_uchar), data, &error);
     cl_mem foundBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_int), nullptr, &error);
@@ -167,40 +359,119 @@ extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* d
     for (auto& buf : buffers) {
         if (!buf) {
             std::cerr << "Error allocating buffer." << std::endl;
-            releaseResources(context, commandQueue, program, kernel, buffers, 4);
+            releaseResources(context, commandQueue, nullptr, nullptr, buffers, 4);
             return -1;
         }
     }
     cl_int foundValue = 0;
-    error = clEnqueueWriteBuffer(commandQueue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &foundValue, 0, nullptr, nullptr);
-    error |= clSetKernelArg(kernel, 0, sizeof(cl_int), &dataSize);
-    error |= clSetKernelArg(kernel, 1, sizeof(cl_ulong), &startNonce);
-    error |= clSetKernelArg(kernel, 2, sizeof(cl_int), &nonceOffset);
-    error |= clSetKernelArg(kernel, 3, sizeof(cl_ulong), &batchSize);
-    error |= clSetKernelArg(kernel, 4, sizeof(cl_int), &difficulty);
-    error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &deviceDataBuffer);
-    error |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &foundBuffer);
-    error |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &outputBuffer);
-    error |= clSetKernelArg(kernel, 8, sizeof(cl_mem), &validNonceBuffer);
-    if (error != CL_SUCCESS) {
-        std::cerr << "Error: " << error << std::endl;
-        releaseResources(context, commandQueue, program, kernel, buffers, 4);
-        return -1;
-    }
+    CL_CALL(clEnqueueWriteBuffer(commandQueue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &foundValue, 0, nullptr, nullptr));
 
     size_t maxWorkGroupSize;
     clGetDeviceInfo(selectedDevice, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(size_t), &maxWorkGroupSize, NULL);
     size_t localWorkSize = std::min(static_cast<size_t>(threadsPerBlock), maxWorkGroupSize);
-    size_t globalWorkSize = ((batchSize + localWorkSize - 1) / localWorkSize) * localWorkSize;
-    error = clEnqueueNDRangeKernel(commandQueue, kernel, 1, nullptr, &globalWorkSize, &localWorkSize, 0, nullptr, nullptr);
-    if (error != CL_SUCCESS) {
+    // Runs [start, start + count) to completion, ILP nonces per work-item. Returns the found flag.
+    auto launch = [&](cl_kernel kernel, int ilp, std::uint64_t start, std::uint64_t count) {
+        error = clSetKernelArg(kernel, 0, sizeof(cl_int), &dataSize);
+        error |= clSetKernelArg(kernel, 1, sizeof(cl_ulong), &start);
+        error |= clSetKernelArg(kernel, 2, sizeof(cl_int), &nonceOffset);
+        error |= clSetKernelArg(kernel, 3, sizeof(cl_ulong), &count);
+        error |= clSetKernelArg(kernel, 4, sizeof(cl_int), &difficulty);
+        error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &deviceDataBuffer);
+        error |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &foundBuffer);
+        error |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &outputBuffer);
+        error |= clSetKernelArg(kernel, 8, sizeof(cl_mem), &validNonceBuffer);
+        std::uint64_t items = (count + ilp - 1) / ilp;
+        size_t globalWorkSize = ((items + localWorkSize - 1) / localWorkSize) * localWorkSize;
+        if (error == CL_SUCCESS) {
+            error = clEnqueueNDRangeKernel(commandQueue, kernel, 1, nullptr, &globalWorkSize, &localWorkSize, 0, nullptr, nullptr);
+        }
+        if (error != CL_SUCCESS) {
+            return -1;
+        }
+        clFinish(commandQueue);
+        CL_CALL(clEnqueueReadBuffer(commandQueue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &foundValue, 0, nullptr, nullptr));
+        return static_cast<int>(foundValue);
+    };
+
+    // Interleaved multi-state variants only apply to single-block messages. The width is chosen on
+    // the first batch: variants using more private memory per nonce than the scalar kernel (i.e.
+    // spilling registers) are dropped, the rest are timed on consecutive slices of the batch and
+    // the fastest is kept for the process. Measurement restarts if a slice finds the solution.
+    // Batches too small to give each width a full work group per lane run the scalar kernel and
+    // leave the choice to a later batch.
+    static int selectedIlp = 0;
+    static const int ilpWidths[] = {1, 2, 4};
+    bool singleBlock = dataSize < 136;
+    bool measurable = batchSize >= 4 * 4 * static_cast<std::uint64_t>(localWorkSize);
+    int ilp = !singleBlock ? 1 : (selectedIlp > 0 || measurable ? selectedIlp : 1);
+    cl_program program = nullptr;
+    cl_kernel kernel = nullptr;
+    std::uint64_t done = 0;
+    int result = 0;
+    if (ilp == 0) {
+        cl_ulong scalarPrivate = 0;
+        double bestRate = 0;
+        std::uint64_t slice = batchSize / 4;
+        std::ostringstream report;
+        for (int width : ilpWidths) {
+            cl_program candidateProgram;
+            cl_kernel candidateKernel;
+            if (!buildKernel(width, candidateProgram, candidateKernel)) {
+                releaseResources(nullptr, nullptr, candidateProgram, candidateKernel, nullptr, 0);
+                if (width == 1) {
+                    releaseResources(context, commandQueue, program, kernel, buffers, 4);
+                    return -1;
+                }
+                continue;
+            }
+            cl_ulong privateMem = 0;
+            clGetKernelWorkGroupInfo(candidateKernel, selectedDevice, CL_KERNEL_PRIVATE_MEM_SIZE, sizeof(privateMem), &privateMem, nullptr);
+            if (width == 1) {
+                scalarPrivate = privateMem;
+            }
+            report << " x" << width << ": " << privateMem << " B";
+            if (width > 1 && privateMem > scalarPrivate * width) {
+                report << " (spills)";
+                releaseResources(nullptr, nullptr, candidateProgram, candidateKernel, nullptr, 0);
+                continue;
+            }
+            auto startTime = std::chrono::high_resolution_clock::now();
+            result = launch(candidateKernel, width, startNonce + done, slice);
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            done += slice;
+            double rate = slice / std::max(elapsed.count(), 1e-9);
+            report << " " << std::fixed << std::setprecision(1) << rate / 1e6 << " MH/s";
+            if (result == 0 && (!kernel || rate > bestRate)) {
+                releaseResources(nullptr, nullptr, program, kernel, nullptr, 0);
+                program = candidateProgram;
+                kernel = candidateKernel;
+                ilp = width;
+                bestRate = rate;
+            } else {
+                releaseResources(nullptr, nullptr, candidateProgram, candidateKernel, nullptr, 0);
+            }
+            if (result != 0) {
+                break;
+            }
+        }
+        if (result == 0) {
+            selectedIlp = ilp;
+        }
+        if (result == 0 && showDeviceInfo) {
+            std::cout << "[GPU] OpenCL ILP x" << ilp << " selected (private mem/throughput" << report.str() << ")" << std::endl;
+        }
+    } else if (!buildKernel(ilp, program, kernel)) {
+        releaseResources(context, commandQueue, program, kernel, buffers, 4);
+        return -1;
+    }
+    if (result == 0 && done < batchSize) {
+        result = launch(kernel, ilp, startNonce + done, batchSize - done);
+    }
+    if (result < 0) {
         std::cerr << "Error: " << error << std::endl;
         releaseResources(context, commandQueue, program, kernel, buffers, 4);
         return -1;
     }
-
-    clFinish(commandQueue);
-    CL_CALL(clEnqueueReadBuffer(commandQueue, foundBuffer, CL_TRUE, 0, sizeof(cl_int), &foundValue, 0, nullptr, nullptr));
     if (foundValue == 1) {
         CL_CALL(clEnqueueReadBuffer(commandQueue, outputBuffer, CL_TRUE, 0, 32 * sizeof(cl_uchar), output, 0, nullptr, nullptr));
         CL_CALL(clEnqueueReadBuffer(commandQueue, validNonceBuffer, CL_TRUE, 0, sizeof(cl_ulong), validNonce, 0, nullptr, nullptr));
@@ -208,3 +479,32 @@ extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* d
     releaseResources(context, commandQueue, program, kernel, buffers, 4);
     return foundValue;
 }
+
+// Runtime-loaded backend entry points (make plugins, see utils/backend.h).
+// The probe counts the devices executeKernel can use and never exits: a missing or
+// empty ICD simply reports zero devices.
+extern "C" int kaleBackendProbe(const char* platform) {
+    cl_uint numPlatforms = 0;
+    if (clGetPlatformIDs(0, nullptr, &numPlatforms) != CL_SUCCESS || numPlatforms == 0) {
+        return 0;
+    }
+    std::vector<cl_platform_id> platforms(numPlatforms);
+    if (clGetPlatformIDs(numPlatforms, platforms.data(), nullptr) != CL_SUCCESS) {
+        return 0;
+    }
+    cl_platform_id platformId = platforms[0];
+    for (cl_uint i = 0; platform && *platform && i < numPlatforms; ++i) {
+        char name[256] = {};
+        if (clGetPlatformInfo(platforms[i], CL_PLATFORM_NAME, sizeof(name) - 1, name, nullptr) == CL_SUCCESS && std::strcmp(name, platform) == 0) {
+            platformId = platforms[i];
+            break;
+        }
+    }
+    return static_cast<int>(platformDevices(platformId).size());
+}
+
+extern "C" int kaleBackendExecute(const char* platform, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset,
+    std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo) {
+    return executeKernel(platform, deviceId, data, dataSize, startNonce, nonceOffset, batchSize, difficulty, threadsPerBlock,
+        output, validNonce, showDeviceInfo);
+}
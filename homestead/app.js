@@ -161,10 +161,14 @@ async function mine(minerExec, block, hash, nonce, difficulty, key, maxThreads,
     return new Promise((resolve, reject) => {
         const args = [
             block, hash, nonce, difficulty, key,
-            '--max-threads', maxThreads,
             '--batch-size', batchSize,
             '--device', device
         ];
+        // 0 leaves the CPU thread count to the miner's --autotune-cpu profile.
+        if (maxThreads) {
+            args.push('--max-threads');
+            args.push(maxThreads);
+        }
         if (gpu) args.push('--gpu');
         if (verbose) args.push('--verbose');
         if (platform) {
@@ -19,6 +19,15 @@ inline int load(__global volatile int *p) { return atomic_cmpxchg(p, 0, 0); }
 
 #define maxDataSize 256
 
+// The host fixes the KALE message layout (-D DATA_SIZE=76 -D NONCE_OFFSET=4) and difficulties
+// up to 16 nibbles (-D DIFFICULTY=<n>) at program build time, see clprog.cpp.
+#ifndef DATA_SIZE
+#define DATA_SIZE dataSize
+#endif
+#ifndef NONCE_OFFSET
+#define NONCE_OFFSET nonceOffset
+#endif
+
 void keccak256(const uchar* input, size_t size, uchar* output);  // See utils/keccak.cl (concatenated at runtime).
 
 inline void updateNonce(ulong val, uchar* buffer) {
@@ -38,38 +47,221 @@ inline int check(const uchar* hash, int difficulty) {
     return zeros == difficulty;
 }
 
+#ifdef DIFFICULTY
+// Same acceptance as check() as a mask compare on the first little-endian hash word: the leading
+// DIFFICULTY nibbles are zero and, for odd difficulties, the next nibble is not.
+#define DIFFICULTY_BYTES (DIFFICULTY / 2)
+#define DIFFICULTY_MASK ((DIFFICULTY_BYTES >= 8 ? 0xFFFFFFFFFFFFFFFFUL : ((1UL << (8 * (DIFFICULTY_BYTES & 7))) - 1)) \
+    | ((DIFFICULTY & 1) ? (0xF0UL << (8 * (DIFFICULTY_BYTES & 7))) : 0UL))
+#define DIFFICULTY_NEXT ((DIFFICULTY & 1) ? (0x0FUL << (8 * (DIFFICULTY_BYTES & 7))) : 0UL)
+
+inline int checkWord(const uchar* hash) {
+    ulong word = 0;
+    for (int i = 0; i < 8; ++i) {
+        word |= ((ulong)hash[i]) << (8 * i);
+    }
+    return (word & DIFFICULTY_MASK) == 0 && (DIFFICULTY_NEXT == 0 || (word & DIFFICULTY_NEXT) != 0);
+}
+#define CHECK(hash) checkWord(hash)
+#else
+#define CHECK(hash) check(hash, difficulty)
+#endif
+
+// Cooperative found-flag polling: rather than every work-item reading the global flag after every
+// nonce, one lane per subgroup (per work-group without subgroup support) reads it every
+// POLL_INTERVAL iterations and broadcasts it, so a work-item hashes at most POLL_INTERVAL nonces
+// after a solution is published. Polls sit in uniform control flow (see run()).
+#ifndef POLL_INTERVAL
+#define POLL_INTERVAL 8
+#endif
+
+#if defined(cl_khr_subgroups) || defined(__opencl_c_subgroups)
+#ifdef cl_khr_subgroups
+#pragma OPENCL EXTENSION cl_khr_subgroups : enable
+#endif
+inline int pollFound(__global atomic_int_t* found) {
+    int value = get_sub_group_local_id() == 0 ? load(found) : 0;
+    return sub_group_broadcast(value, 0);
+}
+#define POLL(found, flag) pollFound(found)
+#else
+inline int pollGroup(__global atomic_int_t* found, __local volatile int* flag) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+    if (get_local_id(0) == 0) {
+        *flag = load(found);
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    return *flag;
+}
+#define POLL(found, flag) pollGroup(found, flag)
+#endif
+
 inline void copy(uchar* dest, const __global uchar* src, int size) {
     for (int i = 0; i < size; ++i) {
         dest[i] = src[i]; // TODO: optimize with vectorized copy.
     }
 }
 
+#if defined(ILP) && ILP > 1
+// Multi-state variant (-D ILP=2|4): each work-item hashes ILP consecutive nonces with interleaved
+// Keccak states held in ulong vectors, giving the scheduler independent dependency chains to hide
+// latency with. Single-block messages only (DATA_SIZE < 136); the host selects the width.
+#define LANES_CAT(a, b) a##b
+#define LANES_TYPE(n) LANES_CAT(ulong, n)
+#define LANES_STORE(n) LANES_CAT(vstore, n)
+typedef LANES_TYPE(ILP) lanes_t;
+#if ILP == 2
+#define LANE_INDEX ((lanes_t)(0, 1))
+#else
+#define LANE_INDEX ((lanes_t)(0, 1, 2, 3))
+#endif
+
+inline lanes_t rotlLanes(lanes_t x, uint n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+// Big-endian nonce bytes as a little-endian state word.
+inline lanes_t swapLanes(lanes_t x) {
+    x = ((x & 0x00FF00FF00FF00FFUL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFUL);
+    x = ((x & 0x0000FFFF0000FFFFUL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFUL);
+    return (x << 32) | (x >> 32);
+}
+
+inline void keccakF1600Lanes(lanes_t* state) {
+    for (int round = 0; round < 24; ++round) {
+        lanes_t C[5];
+        for (int x = 0; x < 5; ++x)
+            C[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+
+        for (int x = 0; x < 5; ++x) {
+            lanes_t D = C[(x + 4) % 5] ^ rotlLanes(C[(x + 1) % 5], 1);
+            for (int y = 0; y < 25; y += 5)
+                state[y + x] ^= D;
+        }
+
+        lanes_t temp = state[1];
+        for (int i = 0; i < 24; ++i) {
+            int index = piIndexes[i];
+            lanes_t t = state[index];
+            state[index] = rotlLanes(temp, rhoOffsets[i]);
+            temp = t;
+        }
+
+        for (int y = 0; y < 25; y += 5) {
+            lanes_t row[5];
+            for (int x = 0; x < 5; ++x)
+                row[x] = state[y + x];
+            for (int x = 0; x < 5; ++x)
+                state[y + x] = row[x] ^ ((~row[(x + 1) % 5]) & row[(x + 2) % 5]);
+        }
+
+        state[0] ^= roundConstants[round];
+    }
+}
+
+__kernel void run(int dataSize, ulong startNonce, int nonceOffset, ulong batchSize, int difficulty,
+    __global const uchar* deviceData, __global atomic_int_t* found, __global uchar* output, __global ulong* validNonce
+) {
+    __local volatile int groupFound;
+    ulong idx = get_global_id(0);
+    ulong items = get_global_size(0);
+    if (DATA_SIZE >= 136)
+        return;
+
+    // Padded block with the nonce zeroed, as words; each lane XORs its own nonce in.
+    uchar block[136];
+    for (int i = 0; i < 136; ++i) {
+        block[i] = (i < DATA_SIZE && (i < NONCE_OFFSET || i >= NONCE_OFFSET + 8)) ? deviceData[i] : 0;
+    }
+    block[DATA_SIZE] ^= 0x01;
+    block[135] ^= 0x80;
+    ulong base[17];
+    for (int w = 0; w < 17; ++w) {
+        base[w] = 0;
+        for (int j = 0; j < 8; ++j) {
+            base[w] |= ((ulong)block[w * 8 + j]) << (8 * j);
+        }
+    }
+    int nonceWord = NONCE_OFFSET / 8;
+    uint nonceShift = (NONCE_OFFSET % 8) * 8;
+
+    // Same uniform polling loop as the scalar kernel, ILP nonces per step.
+    ulong iterations = (batchSize + items * ILP - 1) / (items * ILP);
+    int active = 1;
+    for (ulong step = 0; step < iterations; ++step) {
+        if (step % POLL_INTERVAL == 0 && POLL(found, &groupFound))
+            break;
+        ulong offset = (idx + step * items) * ILP;
+        if (!active || offset >= batchSize)
+            continue;
+        lanes_t word = swapLanes((lanes_t)(startNonce + offset) + LANE_INDEX);
+        lanes_t state[25];
+        for (int w = 0; w < 25; ++w) {
+            state[w] = (lanes_t)(w < 17 ? base[w] : 0UL);
+        }
+        state[nonceWord] ^= word << nonceShift;
+        if (nonceShift != 0) {
+            state[nonceWord + 1] ^= word >> (64 - nonceShift);
+        }
+        keccakF1600Lanes(state);
+
+        ulong words[4][ILP];
+        for (int w = 0; w < 4; ++w) {
+            LANES_STORE(ILP)(state[w], 0, words[w]);
+        }
+        for (int lane = 0; lane < ILP && offset + lane < batchSize; ++lane) {
+            uchar hash[32];
+            for (int i = 0; i < 32; ++i) {
+                hash[i] = (uchar)(words[i / 8][lane] >> (8 * (i % 8)));
+            }
+            if (CHECK(hash)) {
+                if (atomic_cmpxchg((volatile __global int*)found, 0, 1) == 0) {
+                    for (int i = 0; i < 32; ++i) {
+                        output[i] = hash[i];
+                    }
+                    *validNonce = startNonce + offset + lane;
+                }
+                active = 0;
+                break;
+            }
+        }
+    }
+}
+#else
 __kernel void run(int dataSize, ulong startNonce, int nonceOffset, ulong batchSize, int difficulty,
     __global const uchar* deviceData, __global atomic_int_t* found, __global uchar* output, __global ulong* validNonce
 ) {
+    __local volatile int groupFound;
     ulong idx = get_global_id(0);
     ulong stride = get_global_size(0);
-    if (dataSize > maxDataSize || idx >= batchSize || load(found) == 1)
+    if (DATA_SIZE > maxDataSize)
         return;
-    ulong nonceEnd = startNonce + batchSize;
     uchar threadData[maxDataSize];
-    copy(threadData, deviceData, dataSize);
+    copy(threadData, deviceData, DATA_SIZE);
 
-    // Nonce distribution is based on thread id - spaced by stride.
-    for (ulong nonce = startNonce + idx; nonce < nonceEnd; nonce += stride) {
-        updateNonce(nonce, &threadData[nonceOffset]);
+    // Nonce distribution is based on thread id - spaced by stride. Every work-item runs the same
+    // number of iterations so polls stay uniform; items past the batch or done idle until a poll.
+    ulong iterations = (batchSize + stride - 1) / stride;
+    int active = 1;
+    for (ulong step = 0; step < iterations; ++step) {
+        if (step % POLL_INTERVAL == 0 && POLL(found, &groupFound))
+            break;
+        ulong offset = idx + step * stride;
+        if (!active || offset >= batchSize)
+            continue;
+        ulong nonce = startNonce + offset;
+        updateNonce(nonce, &threadData[NONCE_OFFSET]);
         uchar hash[32];
-        keccak256(threadData, dataSize, hash);
-        if (check(hash, difficulty)) {
+        keccak256(threadData, DATA_SIZE, hash);
+        if (CHECK(hash)) {
             if (atomic_cmpxchg((volatile __global int*)found, 0, 1) == 0) {
                 for (int i = 0; i < 32; ++i) {
                     output[i] = hash[i];
                 }
                 *validNonce = nonce;
             }
-            return;
+            active = 0;
         }
-        if (load(found) == 1)
-            return;
     }
 }
+#endif
@@ -45,6 +45,29 @@ __device__ __forceinline__ bool check(const std::uint8_t* hash, int difficulty)
     return zeros == difficulty;
 }
 
+// Same acceptance as check() as a mask compare on the first hash word (see difficultyMask).
+template<typename Word>
+__device__ __forceinline__ bool checkWord(const std::uint8_t* hash, std::uint64_t mask, std::uint64_t next) {
+    Word word = 0;
+    #pragma unroll
+    for (int i = 0; i < static_cast<int>(sizeof(Word)); ++i) {
+        word |= static_cast<Word>(hash[i]) << (8 * i);
+    }
+    return (word & static_cast<Word>(mask)) == 0 && (next == 0 || (word & static_cast<Word>(next)) != 0);
+}
+
+// Leading `difficulty` nibbles of the little-endian first word must be zero; for odd difficulties
+// check() also requires the following nibble to be non-zero.
+static void difficultyMask(int difficulty, std::uint64_t& mask, std::uint64_t& next) {
+    int bytes = difficulty / 2;
+    mask = bytes >= 8 ? ~0ULL : ((1ULL << (8 * bytes)) - 1);
+    next = 0;
+    if ((difficulty & 1) && bytes < 8) {
+        mask |= 0xF0ULL << (8 * bytes);
+        next = 0x0FULL << (8 * bytes);
+    }
+}
+
 __device__ __forceinline__ void vCopy(std::uint8_t* dest, const std::uint8_t* src, int size) {
     // Align then copy 8 bytes at a time, more efficient than memcpy.
     int i = 0;
@@ -62,22 +85,31 @@ __device__ __forceinline__ void vCopy(std::uint8_t* dest, const std::uint8_t* sr
     }
 }
 
+// DataSize/NonceOffset == 0 read the runtime layout; Tier 8/16 checks difficulty with a 32/64-bit
+// mask compare, Tier 0 with the generic check().
+template<int DataSize, int NonceOffset, int Tier>
 __global__ void run(int dataSize, std::uint64_t startNonce, int nonceOffset, std::uint64_t batchSize, int difficulty,
+                                 std::uint64_t mask, std::uint64_t next,
                                  int* __restrict__ found, std::uint8_t* __restrict__ output, std::uint64_t* __restrict__ validNonce) {
+    const int size = DataSize ? DataSize : dataSize;
+    const int offset = DataSize ? NonceOffset : nonceOffset;
     std::uint64_t idx = blockIdx.x * blockDim.x + threadIdx.x;
     std::uint64_t stride = gridDim.x * blockDim.x;
-    if (dataSize > maxDataSize || idx >= batchSize || atomicAdd(found, 0) == 1)
+    if (size > maxDataSize || idx >= batchSize || atomicAdd(found, 0) == 1)
         return;
     std::uint64_t nonceEnd = startNonce + batchSize;
     std::uint8_t threadData[maxDataSize];
-    vCopy(threadData, deviceData, dataSize);
+    vCopy(threadData, deviceData, size);
 
     // Nonce distribution is based on thread id - spaced by stride.
     for (std::uint64_t nonce = startNonce + idx; nonce < nonceEnd; nonce += stride) {
-        updateNonce(nonce, &threadData[nonceOffset]);
+        updateNonce(nonce, &threadData[offset]);
         std::uint8_t hash[32];
-        keccak256(threadData, dataSize, hash);
-        if (check(hash, difficulty)) {
+        keccak256(threadData, size, hash);
+        bool hit = Tier == 8 ? checkWord<std::uint32_t>(hash, mask, next)
+            : Tier == 16 ? checkWord<std::uint64_t>(hash, mask, next)
+            : check(hash, difficulty);
+        if (hit) {
             if (atomicCAS(found, 0, 1) == 0) {
                 memcpy(output, hash, 32);
                 atomicExch(reinterpret_cast<unsigned long long int*>(validNonce), static_cast<unsigned long long int>(nonce));
@@ -119,8 +151,19 @@ extern "C" int executeKernel(int deviceId, std::uint8_t* data, int dataSize, std
         blocks = deviceProp.maxGridSize[0];
     }
     std::uint64_t adjustedBatchSize = blocks * threads;
-    run<<<(unsigned int)blocks, threads>>>(dataSize, startNonce,
-        nonceOffset, adjustedBatchSize, difficulty, deviceFound, deviceOutput, deviceNonce);
+    // Runtime dispatch onto the layout x difficulty tier instantiations.
+    using RunFn = void (*)(int, std::uint64_t, int, std::uint64_t, int, std::uint64_t, std::uint64_t,
+        int*, std::uint8_t*, std::uint64_t*);
+    static const RunFn kernels[2][3] = {
+        { run<76, 4, 8>, run<76, 4, 16>, run<76, 4, 0> },
+        { run<0, 0, 8>, run<0, 0, 16>, run<0, 0, 0> }
+    };
+    std::uint64_t mask = 0, next = 0;
+    difficultyMask(difficulty, mask, next);
+    int tier = (difficulty >= 1 && difficulty <= 8) ? 0 : (difficulty >= 1 && difficulty <= 16) ? 1 : 2;
+    RunFn kernel = kernels[(dataSize == 76 && nonceOffset == 4) ? 0 : 1][tier];
+    kernel<<<(unsigned int)blocks, threads>>>(dataSize, startNonce,
+        nonceOffset, adjustedBatchSize, difficulty, mask, next, deviceFound, deviceOutput, deviceNonce);
     CUDA_CALL(cudaDeviceSynchronize());
     CUDA_CALL(cudaMemcpy(output, deviceOutput, outputSize, cudaMemcpyDeviceToHost));
     CUDA_CALL(cudaMemcpy(&found, deviceFound, sizeof(int), cudaMemcpyDeviceToHost));
@@ -130,3 +173,16 @@ extern "C" int executeKernel(int deviceId, std::uint8_t* data, int dataSize, std
     CUDA_CALL(cudaFree(deviceNonce));
     return found;
 }
+
+// Runtime-loaded backend entry points (make plugins, see utils/backend.h).
+// The probe never exits: without a driver or device cudaGetDeviceCount fails and reports zero.
+extern "C" int kaleBackendProbe(const char*) {
+    int count = 0;
+    return cudaGetDeviceCount(&count) == cudaSuccess ? count : 0;
+}
+
+extern "C" int kaleBackendExecute(const char*, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset,
+    std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo) {
+    return executeKernel(deviceId, data, dataSize, startNonce, nonceOffset, batchSize, difficulty, threadsPerBlock,
+        output, validNonce, showDeviceInfo);
+}
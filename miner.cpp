@@ -18,13 +18,25 @@
 #include <functional>
 #include <sstream>
 #include <algorithm>
+#include <fstream>
+#include <cctype>
+#include <memory>
 
 #include "utils/keccak.h"
 #include "utils/misc.h"
+#include "utils/topk.h"
+#include "utils/engine.h"
+#include "utils/pow_template.h"
+#include "utils/autotune.h"
+#include "utils/pressure.h"
+#include "utils/thermal.h"
+#include "utils/recorder.h"
+#include "utils/jobstore.h"
 
 #define GPU_NONE 0
 #define GPU_CUDA 1
 #define GPU_OPENCL 2
+#define GPU_VULKAN 3
 
 #ifndef GPU
 #define GPU GPU_NONE
@@ -42,24 +54,18 @@ extern "C" int executeKernel(int deviceId, std::uint8_t* data, int dataSize, std
 #endif
 extern "C" int executeKernel(const char* platform, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset,
     std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo);
+#elif GPU == GPU_VULKAN
+extern "C" int executeKernel(int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset,
+    std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo);
+#else
+#include "utils/backend.h"
 #endif
 
 static const std::uint64_t defaultBatchSize = 10000000;
 static const int defaultMaxThreads = 4;
-static const int hashRateInterval = 5000;
 static std::atomic<bool> found(false);
 static std::atomic<std::uint64_t> hashMetric(0);
 
-bool check(const std::vector<std::uint8_t>& hash, int difficulty) {
-    int zeros = 0;
-    for (std::uint8_t byte : hash) {
-        zeros += (byte == 0) ? 2 : ((byte >> 4) == 0 ? 1 : 0);
-        if (byte != 0 || zeros >= difficulty)
-            break;
-    }
-    return zeros >= difficulty;
-}
-
 std::vector<std::uint8_t> prepare(std::uint32_t block, std::uint64_t nonce,
     const std::string& base64Hash, const std::string& miner, size_t& nonceOffset
 ) {
@@ -83,49 +89,492 @@ std::vector<std::uint8_t> prepare(std::uint32_t block, std::uint64_t nonce,
     return data;
 }
 
-std::pair<std::vector<std::uint8_t>, std::uint64_t> find(std::uint32_t block, const std::string& base64Hash,
-    std::uint64_t nonce, int difficulty, const std::string& miner,
-    bool verbose, std::uint64_t batchSize) {
-    std::uint64_t counter = 0;
-    int hashRateCounter = 0;
-    size_t nonceOffset = 0;
-    std::vector<std::uint8_t> data = prepare(block, nonce, base64Hash, miner, nonceOffset);
-    if (verbose) {
-        std::cout << "[CPU] Mining batch: " << nonce << " block: " << block
-                  << " difficulty: " << difficulty << " hash: " << base64Hash << std::endl;
-        std::cout.flush();
+int leadingZeros(const std::uint8_t* hash) {
+    int zeros = 0;
+    for (int i = 0; i < 32; ++i) {
+        if (hash[i] != 0) {
+            zeros += (hash[i] >> 4) == 0 ? 1 : 0;
+            break;
+        }
+        zeros += 2;
     }
+    return zeros;
+}
 
-    Keccak256 keccak;
-    while (!found.load()) {
-        auto nonceBytes = i64ToBytes(nonce);
-        std::copy(nonceBytes.begin(), nonceBytes.end(), data.begin() + nonceOffset);
+std::string toHex(const std::uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        hex[i * 2] = digits[data[i] >> 4];
+        hex[i * 2 + 1] = digits[data[i] & 0x0F];
+    }
+    return hex;
+}
+
+struct WorkTuple {
+    std::uint64_t line = 0;
+    std::vector<std::uint8_t> data;
+    std::uint64_t nonce = 0;
+    int difficulty = -1;
+    std::uint8_t hash[32];
+    std::string error;
+};
+
+struct VerifyStats {
+    std::uint64_t total = 0;
+    std::uint64_t valid = 0;
+    std::uint64_t errors = 0;
+};
+
+// Parses "<block> <entropy> <miner> <nonce> [difficulty]" (whitespace or comma separated).
+bool parseWorkTuple(const std::string& line, WorkTuple& tuple) {
+    std::string fields[5];
+    size_t count = 0;
+    for (size_t i = 0; i < line.size() && count < 5;) {
+        while (i < line.size() && (std::isspace(static_cast<unsigned char>(line[i])) || line[i] == ',')) ++i;
+        size_t start = i;
+        while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i])) && line[i] != ',') ++i;
+        if (i > start) fields[count++].assign(line, start, i - start);
+    }
+    if (count == 0 || fields[0][0] == '#') {
+        return false;
+    }
+    try {
+        if (count < 4) {
+            throw std::invalid_argument("Expected <block> <entropy> <miner> <nonce> [difficulty].");
+        }
+        if (count == 5) {
+            tuple.difficulty = std::stoi(fields[4]);
+        }
+        tuple.nonce = std::stoull(fields[3]);
+        size_t nonceOffset = 0;
+        tuple.data = prepare(static_cast<std::uint32_t>(std::stoll(fields[0])), tuple.nonce, fields[1], fields[2], nonceOffset);
+    } catch (const std::exception& e) {
+        tuple.error = e.what();
+    }
+    return true;
+}
 
-        keccak.reset();
-        keccak.update(data.data(), data.size());
-        std::vector<std::uint8_t> result(32);
-        keccak.finalize(result.data());
+// Hashes tuples through the batch Keccak API.
+void verifyTuples(std::vector<WorkTuple>& tuples) {
+    std::vector<const std::uint8_t*> inputs;
+    std::vector<size_t> lengths;
+    std::vector<std::uint8_t*> outputs;
+    for (WorkTuple& tuple : tuples) {
+        if (tuple.error.empty()) {
+            inputs.push_back(tuple.data.data());
+            lengths.push_back(tuple.data.size());
+            outputs.push_back(tuple.hash);
+        }
+    }
+    keccak256_many(inputs.data(), lengths.data(), outputs.data(), inputs.size());
+}
 
-        if (check(result, difficulty)) {
-            return {result, nonce};
+// Emits one JSON object per tuple.
+void formatTuples(const std::vector<WorkTuple>& tuples, std::string& output, VerifyStats& stats) {
+    for (const WorkTuple& tuple : tuples) {
+        ++stats.total;
+        output += "{\"line\": " + std::to_string(tuple.line);
+        if (!tuple.error.empty()) {
+            ++stats.errors;
+            output += ", \"error\": \"" + tuple.error + "\"}\n";
+            continue;
         }
+        int zeros = leadingZeros(tuple.hash);
+        output += ", \"nonce\": " + std::to_string(tuple.nonce)
+            + ", \"hash\": \"" + toHex(tuple.hash, 32) + "\", \"zeros\": " + std::to_string(zeros);
+        if (tuple.difficulty >= 0) {
+            bool ok = zeros >= tuple.difficulty;
+            stats.valid += ok;
+            output += std::string(", \"valid\": ") + (ok ? "true" : "false");
+        }
+        output += "}\n";
+    }
+}
 
-        nonce++;
-        counter++;
-        if (counter == batchSize) {
+int verifyBatch(const std::string& path, int maxThreads) {
+    static const size_t chunkSize = 1 << 16;
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = path == "-" ? std::cin : file;
+    std::ios::sync_with_stdio(false);
+
+    // Lines are read in chunks; each worker parses, hashes and formats its own slice.
+    std::uint64_t lineNumber = 0;
+    std::vector<std::string> lines;
+    std::vector<std::string> outputs(maxThreads);
+    std::vector<VerifyStats> stats(maxThreads);
+    std::string line;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    while (input) {
+        lines.clear();
+        while (lines.size() < chunkSize && std::getline(input, line)) {
+            lines.push_back(line);
+        }
+        if (lines.empty()) {
             break;
         }
+        size_t threadCount = std::min<size_t>(maxThreads, lines.size() / KECCAK_LANES + 1);
+        size_t slice = (lines.size() + threadCount - 1) / threadCount;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t) {
+            size_t begin = std::min(lines.size(), t * slice), end = std::min(lines.size(), begin + slice);
+            threads.emplace_back([&, t, begin, end, firstLine = lineNumber + begin]() {
+                std::vector<WorkTuple> tuples;
+                tuples.reserve(end - begin);
+                for (size_t i = begin; i < end; ++i) {
+                    WorkTuple tuple;
+                    tuple.line = firstLine + (i - begin) + 1;
+                    if (parseWorkTuple(lines[i], tuple)) {
+                        tuples.push_back(std::move(tuple));
+                    }
+                }
+                verifyTuples(tuples);
+                outputs[t].clear();
+                formatTuples(tuples, outputs[t], stats[t]);
+            });
+        }
+        for (size_t t = 0; t < threadCount; ++t) {
+            threads[t].join();
+            std::cout.write(outputs[t].data(), outputs[t].size());
+        }
+        lineNumber += lines.size();
+    }
+    std::cout.flush();
+
+    VerifyStats summary;
+    for (const auto& s : stats) {
+        summary.total += s.total;
+        summary.valid += s.valid;
+        summary.errors += s.errors;
+    }
+    std::chrono::duration<double> elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+    std::cerr << "Verified " << summary.total << " tuples (" << summary.valid << " valid, " << summary.errors << " errors) in "
+              << std::fixed << std::setprecision(2) << elapsedTime.count() << "s ("
+              << formatHashRate(summary.total / std::max(elapsedTime.count(), 1e-9)) << ")" << std::endl;
+    return summary.errors > 0 ? 2 : 0;
+}
+
+// The README sample job at an unreachable difficulty.
+Job benchmarkJob(std::uint64_t batchSize) {
+    Job job;
+    job.data = prepare(37, 0, "AAAAAAn66y/43JP7M02rwTmONZoWOmu1OPYz/bmzJ8o=",
+        "GBQHTQ7NTSKHVTSVM6EHUO3TU4P4BK2TAAII25V2TT2Q6OWXUJWEKALE", job.nonceOffset);
+    job.difficulty = 65;
+    job.batchSize = batchSize;
+    return job;
+}
+
+// Built-in benchmark: runs each CPU kernel on the benchmark job.
+int benchmark(int maxThreads, std::uint64_t batchSize, double seconds) {
+    Job job = benchmarkJob(batchSize);
+    EngineOptions options;
+    options.threads = maxThreads;
+    // The pure kernels come first in the registry; the others are also compared with them.
+    std::map<std::string, double> rates;
+    for (const auto& entry : engineRegistry()) {
+        if (std::strcmp(entry.scheduler, PersistentRanges::name) != 0 || std::strcmp(entry.result, FirstHit::name) != 0) {
+            continue;
+        }
+        double hashRate = measureEngine(entry, job, options, seconds);
+        rates[entry.kernel] = hashRate;
+        std::cout << std::fixed << std::setprecision(2)
+                  << "{\"kernel\": \"" << entry.kernel << "\", \"threads\": " << maxThreads
+                  << ", \"hashrate\": " << hashRate << ", \"perThread\": " << hashRate / maxThreads << "}" << std::endl;
+        std::cerr << "[CPU] " << entry.kernel << ": " << formatHashRate(hashRate) << " (" << formatHashRate(hashRate / maxThreads) << " per thread";
+        for (const char* pure : {MultiBufferKernel<KaleLayout>::name, ScalarKernel<KaleLayout>::name}) {
+            if (rates.count(pure) && rates[pure] > 0 && entry.kernel != std::string(pure)) {
+                std::cerr << ", " << std::fixed << std::showpos << std::setprecision(1) << (hashRate / rates[pure] - 1) * 100 << std::noshowpos << "% vs " << pure;
+            }
+        }
+        std::cerr << ")" << std::endl;
+    }
+    return 0;
+}
+
+// Quoted JSON string; daemon ids come from stdin verbatim.
+std::string jsonString(const std::string& text) {
+    static const char digits[] = "0123456789abcdef";
+    std::string quoted = "\"";
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += static_cast<char>(c);
+        } else if (c < 0x20) {
+            quoted += std::string("\\u00") + digits[c >> 4] + digits[c & 0x0F];
+        } else {
+            quoted += static_cast<char>(c);
+        }
+    }
+    return quoted + "\"";
+}
+
+// Daemon workers over `jobs` copies of the benchmark job (distinct blocks) for `seconds`.
+double measureJobSlices(size_t jobs, int maxThreads, std::uint64_t sliceSize, double seconds, double& switchNanos) {
+    JobStore store(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        Job job;
+        job.data = prepare(static_cast<std::uint32_t>(i + 1), 0, "AAAAAAn66y/43JP7M02rwTmONZoWOmu1OPYz/bmzJ8o=",
+            "GBQHTQ7NTSKHVTSVM6EHUO3TU4P4BK2TAAII25V2TT2Q6OWXUJWEKALE", job.nonceOffset);
+        job.difficulty = 64;
+        store.insert(std::to_string(i), job);
+    }
+    std::atomic<bool> stop(false);
+    std::vector<SliceStats> stats(maxThreads);
+    std::vector<std::thread> threads;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < maxThreads; ++t) {
+        threads.emplace_back([&, t]() { runJobSlices(store, sliceSize, stop, stats[t], [](const JobSlice&, const std::uint8_t*, std::uint64_t) {}); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+    std::uint64_t hashes = 0, switches = 0, nanos = 0;
+    for (const auto& worker : stats) {
+        hashes += worker.hashes.load();
+        switches += worker.switches.load();
+        nanos += worker.switchNanos.load();
+    }
+    switchNanos = switches > 0 ? static_cast<double>(nanos) / switches : 0;
+    return hashes / elapsedTime.count();
+}
+
+// Daemon scheduling cost: one job against `jobs` jobs with the same slice size. The switch time
+// is measured around picking the next slice and loading its block.
+int benchmarkJobs(size_t jobs, int maxThreads, std::uint64_t sliceSize, double seconds) {
+    double singleSwitch = 0, manySwitch = 0;
+    double single = measureJobSlices(1, maxThreads, sliceSize, seconds, singleSwitch);
+    double many = measureJobSlices(jobs, maxThreads, sliceSize, seconds, manySwitch);
+    double sliceNanos = many > 0 ? sliceSize / (many / maxThreads) * 1e9 : 0;
+    std::cout << std::fixed << std::setprecision(2) << "{\"jobs\": " << jobs << ", \"slice\": " << sliceSize
+              << ", \"threads\": " << maxThreads << ", \"hashrate\": " << many << ", \"singleJob\": " << single
+              << ", \"switchNs\": " << manySwitch << "}" << std::endl;
+    std::cerr << std::fixed << "[DAEMON] " << jobs << " jobs: " << formatHashRate(many) << " (" << std::showpos << std::setprecision(1)
+              << (single > 0 ? (many / single - 1) * 100 : 0) << std::noshowpos << "% vs 1 job), switch "
+              << std::setprecision(0) << manySwitch << " ns (" << singleSwitch << " ns with 1 job), "
+              << std::setprecision(3) << (sliceNanos > 0 ? manySwitch / sliceNanos * 100 : 0) << "% of a "
+              << sliceSize << "-nonce slice" << std::endl;
+    return 0;
+}
+
+// Long-running mode for many farmers: jobs are added and cancelled on stdin and hashed in
+// micro-slices round-robin (jobstore.h); each hit completes its job and is written to stdout.
+//   add <id> <block> <hash> <nonce> <difficulty> <miner_address>
+//   cancel <id>
+// Stdout carries only JSON lines, each written whole; --verbose status goes to stderr.
+// Exits once stdin is closed and every job has completed.
+int runDaemon(int maxThreads, size_t capacity, std::uint64_t sliceSize, const std::string& pinning, bool verbose) {
+    JobStore store(capacity);
+    std::mutex outputMutex;
+    auto emit = [&](const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << (line + "\n") << std::flush;
+    };
+    auto onHit = [&](const JobSlice& slice, const std::uint8_t* hash, std::uint64_t nonce) {
+        std::string id;
+        std::uint64_t hashes = 0;
+        if (store.complete(slice, id, hashes)) {
+            emit("{\"id\": " + jsonString(id) + ", \"hash\": \"" + toHex(hash, 32) + "\", \"nonce\": " + std::to_string(nonce)
+                + ", \"hashes\": " + std::to_string(hashes) + "}");
+        }
+    };
+    std::atomic<bool> stop(false);
+    std::vector<SliceStats> stats(maxThreads);
+    std::vector<int> cpus = pinningCpus(pinning);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < maxThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            if (!cpus.empty()) {
+                pinCurrentThread(cpus[t % cpus.size()]);
+            }
+            runJobSlices(store, sliceSize, stop, stats[t], onHit);
+        });
+    }
+    std::thread monitor([&]() {
+        std::uint64_t lastHashes = 0, lastSwitches = 0, lastNanos = 0;
+        while (!stop.load()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::uint64_t hashes = 0, switches = 0, nanos = 0;
+            for (const auto& worker : stats) {
+                hashes += worker.hashes.load();
+                switches += worker.switches.load();
+                nanos += worker.switchNanos.load();
+            }
+            if (verbose && switches > lastSwitches) {
+                std::ostringstream line;
+                line << "[DAEMON] jobs " << store.size() << " | " << formatHashRate(static_cast<double>(hashes - lastHashes))
+                     << " | " << switches - lastSwitches << " switches/s, " << std::fixed << std::setprecision(0)
+                     << static_cast<double>(nanos - lastNanos) / (switches - lastSwitches) << " ns each ("
+                     << std::setprecision(3) << (nanos - lastNanos) / (maxThreads * 1e9) * 100 << "% of worker time)\n";
+                std::cerr << line.str() << std::flush;
+            }
+            lastHashes = hashes;
+            lastSwitches = switches;
+            lastNanos = nanos;
+        }
+    });
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream fields(line);
+        std::string command, id;
+        fields >> command >> id;
+        if (command.empty() || command[0] == '#') {
+            continue;
+        }
+        if (command == "cancel") {
+            emit("{\"id\": " + jsonString(id) + ", \"cancelled\": " + (store.cancel(id) ? "true" : "false") + "}");
+            continue;
+        }
+        try {
+            std::string hash, miner;
+            std::int64_t block = 0, difficulty = 0;
+            std::uint64_t nonce = 0;
+            if (command != "add" || !(fields >> block >> hash >> nonce >> difficulty >> miner)) {
+                throw std::invalid_argument("Expected add <id> <block> <hash> <nonce> <difficulty> <miner_address> or cancel <id>.");
+            }
+            Job job;
+            job.data = prepare(static_cast<std::uint32_t>(block), nonce, hash, miner, job.nonceOffset);
+            job.difficulty = static_cast<int>(difficulty);
+            job.startNonce = nonce;
+            store.insert(id, job);
+            emit("{\"id\": " + jsonString(id) + ", \"added\": true}");
+        } catch (const std::exception& e) {
+            emit("{\"id\": " + jsonString(id) + ", \"error\": " + jsonString(e.what()) + "}");
+        }
+    }
+    while (store.size() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    monitor.join();
+    return 0;
+}
+
+// Throughput from 1 to maxThreads workers under each pinning policy. Efficiency is the rate per
+// worker relative to one worker, the SMT uplift compares all logical CPUs with one worker per
+// physical core, and the knee is the first worker count within 5% of the peak.
+int sweepThreads(const std::string& kernel, int maxThreads, std::uint64_t batchSize, double seconds) {
+    const EngineEntry* entry = findEngine(kernel, PersistentRanges::name, FirstHit::name);
+    if (!entry) {
+        std::cerr << "Unknown --kernel " << kernel << ".\n";
+        return 1;
+    }
+    const CpuTopology& topology = cpuTopology();
+    const int physical = topology.physicalCores, logical = static_cast<int>(topology.compact.size());
+    Job job = benchmarkJob(batchSize);
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(2)
+         << "{\"kernel\": \"" << kernel << "\", \"physicalCores\": " << physical
+         << ", \"logicalCpus\": " << logical << ", \"policies\": [";
+    for (size_t p = 0; p < std::size(pinningPolicies); ++p) {
+        std::vector<double> rates(maxThreads + 1, 0);
+        for (int threads = 1; threads <= maxThreads; ++threads) {
+            EngineOptions options;
+            options.threads = threads;
+            options.cpus = pinningCpus(pinningPolicies[p]);
+            rates[threads] = measureEngine(*entry, job, options, seconds);
+        }
+        double peak = *std::max_element(rates.begin(), rates.end());
+        int knee = 1;
+        while (rates[knee] < peak * 0.95) {
+            ++knee;
+        }
+        bool smt = logical > physical && maxThreads >= logical && rates[physical] > 0;
+        double uplift = smt ? rates[logical] / rates[physical] - 1 : 0;
 
-        hashRateCounter += 1;
-        if (hashRateCounter == hashRateInterval) {
-            hashMetric.fetch_add(hashRateCounter, std::memory_order_relaxed);
-            hashRateCounter = 0;
+        json << (p ? ", " : "") << "{\"pinning\": \"" << pinningPolicies[p] << "\", \"points\": [";
+        std::cerr << "[SWEEP] " << kernel << " pinning: " << pinningPolicies[p] << " knee: " << knee << " threads";
+        if (smt) {
+            std::cerr << ", SMT uplift: " << std::showpos << std::fixed << std::setprecision(1) << uplift * 100 << "%" << std::noshowpos;
         }
+        std::cerr << std::endl;
+        for (int threads = 1; threads <= maxThreads; ++threads) {
+            // Efficiency is undefined (null) when the 1-worker trial measured nothing.
+            bool scaled = rates[1] > 0;
+            double efficiency = scaled ? rates[threads] / (threads * rates[1]) : 0;
+            json << (threads > 1 ? ", " : "") << "[" << threads << ", " << rates[threads] << ", ";
+            if (scaled) {
+                json << efficiency << "]";
+            } else {
+                json << "null]";
+            }
+            int width = peak > 0 ? static_cast<int>(rates[threads] / peak * 50 + 0.5) : 0;
+            std::string percent = scaled ? std::to_string(static_cast<int>(efficiency * 100 + 0.5)) + "%" : "-";
+            std::cerr << std::setw(4) << threads << " |" << std::string(width, '#') << std::string(50 - width, ' ')
+                      << std::setw(14) << formatHashRate(rates[threads]) << std::setw(7) << percent
+                      << (threads == knee ? "  <- knee" : "") << (threads == physical && smt ? "  <- physical cores" : "") << std::endl;
+        }
+        json << "], \"knee\": " << knee << ", \"smtUplift\": ";
+        if (smt) {
+            json << uplift;
+        } else {
+            json << "null";
+        }
+        json << "}";
+    }
+    json << "]}";
+    std::cout << json.str() << std::endl;
+    return 0;
+}
+
+// Searches the CPU configuration space and stores the winner as this host's profile.
+int autotune(int maxThreads, std::uint64_t batchSize, double seconds) {
+    const CpuTopology& topology = cpuTopology();
+    std::cerr << "[AUTOTUNE] " << topology.model << " (microcode " << topology.microcode << "), "
+              << topology.physicalCores << " cores, " << topology.compact.size() << " threads" << std::endl;
+    CpuProfile profile = autotuneCpu(benchmarkJob(batchSize), maxThreads, seconds);
+    if (profile.hashRate <= 0) {
+        std::cerr << "[AUTOTUNE] No trial measured any hashes, profile not written." << std::endl;
+        return 1;
     }
-    return {{}, 0};
+    std::string path = profilePath();
+    if (!saveProfile(profile, path)) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return 1;
+    }
+    std::cout << profileJson(profile) << std::endl;
+    std::cerr << "[AUTOTUNE] Profile saved to " << path << std::endl;
+    return 0;
 }
 
-void monitorHashRate(bool verbose, bool gpu) {
+// Summarizes a --record file (and its rotated predecessor); --csv exports every record.
+int report(const std::string& path, const std::string& csv) {
+    std::vector<StatRecord> records;
+    if (!readStatRecords(path, records)) {
+        std::cerr << "Cannot read " << path << std::endl;
+        return 1;
+    }
+    if (csv == "-") {
+        writeStatCsv(records, std::cout);
+        writeStatReport(records, std::cerr);
+        return 0;
+    }
+    if (!csv.empty()) {
+        std::ofstream file(csv);
+        writeStatCsv(records, file);
+        if (!file) {
+            std::cerr << "Cannot write " << csv << std::endl;
+            return 1;
+        }
+    }
+    writeStatReport(records, std::cout);
+    return 0;
+}
+
+void monitorHashRate(bool verbose, bool gpu, std::vector<std::shared_ptr<Governor>> governors, std::shared_ptr<StatRecorder> recorder) {
     auto startTime = std::chrono::high_resolution_clock::now();
     while (!found.load()) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -134,22 +583,139 @@ void monitorHashRate(bool verbose, bool gpu) {
         double hashRate = gpu ? hashMetric.load() : hashMetric.load() / elapsedTime.count();
         hashMetric.store(0);
         startTime = currentTime;
+        std::string telemetry;
+        for (const auto& governor : governors) {
+            telemetry += " | " + governor->step();
+        }
+        if (recorder) {
+            recorder->sample(hashRate, elapsedTime.count());
+        }
         if (verbose && hashRate > 0) {
-            std::cout << std::fixed << std::setprecision(2)
-                      << (gpu ? "[GPU] Hash Rate: " : "[CPU] Hash Rate: ")
-                      << formatHashRate(hashRate) << "\n";
-            std::cout.flush();
+            AsyncLog::instance().write((gpu ? "[GPU] Hash Rate: " : "[CPU] Hash Rate: ") + formatHashRate(hashRate) + telemetry);
         }
     }
 }
 
 int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::strcmp(argv[1], "--verify-batch") == 0) {
+        int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int i = 3; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+                maxThreads = std::max(1, std::stoi(argv[++i]));
+            }
+        }
+        return verifyBatch(argv[2], maxThreads);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "--benchmark") == 0) {
+        int maxThreads = defaultMaxThreads;
+        std::uint64_t batchSize = 100000;
+        double seconds = 3;
+        bool sweep = false, explicitThreads = false;
+        size_t jobs = 0;
+        std::uint64_t sliceSize = 16384;
+        std::string kernel = KECCAK == 0 ? MultiBufferKernel<KaleLayout>::name : ScalarKernel<KaleLayout>::name;
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+                maxThreads = std::max(1, std::stoi(argv[++i]));
+                explicitThreads = true;
+            } else if (std::strcmp(argv[i], "--batch-size") == 0 && i + 1 < argc) {
+                batchSize = std::stoull(argv[++i]);
+            } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+                seconds = std::stod(argv[++i]);
+            } else if (std::strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+                kernel = argv[++i];
+            } else if (std::strcmp(argv[i], "--sweep-threads") == 0) {
+                sweep = true;
+            } else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+                jobs = std::max(1, std::stoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--slice") == 0 && i + 1 < argc) {
+                sliceSize = std::stoull(argv[++i]);
+            }
+        }
+        if (seconds <= 0) {
+            std::cerr << "--seconds must be positive.\n";
+            return 1;
+        }
+        if (jobs > 0) {
+            return benchmarkJobs(jobs, maxThreads, sliceSize, seconds);
+        }
+        if (sweep) {
+            maxThreads = explicitThreads ? maxThreads : static_cast<int>(cpuTopology().compact.size());
+            return sweepThreads(kernel, maxThreads, batchSize, seconds);
+        }
+        return benchmark(maxThreads, batchSize, seconds);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "--autotune-cpu") == 0) {
+        int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::uint64_t batchSize = 100000;
+        double seconds = 1;
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+                maxThreads = std::max(1, std::stoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--batch-size") == 0 && i + 1 < argc) {
+                batchSize = std::stoull(argv[++i]);
+            } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+                seconds = std::stod(argv[++i]);
+            }
+        }
+        if (seconds <= 0) {
+            std::cerr << "--seconds must be positive.\n";
+            return 1;
+        }
+        return autotune(maxThreads, batchSize, seconds);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "--daemon") == 0) {
+        int maxThreads = defaultMaxThreads;
+        size_t capacity = 4096;
+        std::uint64_t sliceSize = 16384;
+        std::string pinning = "none";
+        bool verbose = false;
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+                maxThreads = std::max(1, std::stoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+                capacity = std::max(1, std::stoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--slice") == 0 && i + 1 < argc) {
+                sliceSize = std::stoull(argv[++i]);
+            } else if (std::strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+                pinning = argv[++i];
+            } else if (std::strcmp(argv[i], "--verbose") == 0) {
+                verbose = true;
+            }
+        }
+        return runDaemon(maxThreads, capacity, sliceSize, pinning, verbose);
+    }
+
+    if (argc >= 3 && std::strcmp(argv[1], "--report") == 0) {
+        std::string csv;
+        for (int i = 3; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+                csv = argv[++i];
+            }
+        }
+        return report(argv[2], csv);
+    }
+
     if (argc < 6) {
         std::cerr << "Usage: " << argv[0]
                   << " <block> <hash> <nonce> <difficulty> <miner_address>\n"
                   << "  [--max-threads <num> (default: " << defaultMaxThreads << ")]\n"
                   << "  [--batch-size <num> (default: " << defaultBatchSize << ")]\n"
-                  << "  [--device <num> (default 0)] [--verbose]\n";
+                  << "  [--device <num> (default 0)] [--top-k <num>] [--verbose]\n"
+                  << "  [--kernel scalar|multibuffer] [--scheduler batch|persistent] [--template <spec>]\n"
+                  << "  [--pin none|compact|scatter] [--no-profile] [--psi-target <percent>] [--psi-memory]\n"
+                  << "  [--thermal-target <celsius>] [--record <file>] [--record-size <MB> (default: 16)]\n"
+                  << "  [--gpu] [--gpu-backend cuda|opencl|vulkan] [--platform <name>]\n"
+                  << "   or: " << argv[0] << " --benchmark [--max-threads <num>] [--batch-size <num>] [--seconds <num> (default: 3)]\n"
+                  << "   or: " << argv[0] << " --benchmark --sweep-threads [--kernel <name>] [--max-threads <num> (default: all cores)] [--seconds <num>]\n"
+                  << "   or: " << argv[0] << " --autotune-cpu [--max-threads <num> (default: all cores)] [--seconds <num> (default: 1)]\n"
+                  << "   or: " << argv[0] << " --verify-batch <file|-> [--max-threads <num> (default: all cores)]\n"
+                  << "   or: " << argv[0] << " --report <file> [--csv <file|->]\n"
+                  << "   or: " << argv[0] << " --daemon [--max-threads <num>] [--jobs <capacity> (default: 4096)] [--slice <nonces> (default: 16384)] [--pin <policy>] [--verbose]\n"
+                  << "   or: " << argv[0] << " --benchmark --jobs <num> [--slice <nonces>] [--max-threads <num>] [--seconds <num>]\n";
         return 1;
     }
 
@@ -159,64 +725,209 @@ int main(int argc, char* argv[]) {
     int difficulty = std::stoi(argv[4]);
     std::string miner = argv[5];
     std::string platform;
+    std::string gpuBackend;
 
     bool verbose = false;
     bool gpu = false;
     int deviceId = 0;
     std::uint64_t batchSize = defaultBatchSize;
     int maxThreads = defaultMaxThreads;
+    size_t topCount = 0;
+    std::string kernel = KECCAK == 0 ? MultiBufferKernel<KaleLayout>::name : ScalarKernel<KaleLayout>::name;
+    std::string scheduler = SpawnPerBatch::name;
+    std::string templateSpec;
+    std::string pinning = "none";
+    bool useProfile = true;
+    double psiTarget = 0;
+    double thermalTarget = 0;
+    bool psiMemory = false;
+    std::string recordPath;
+    std::uint64_t recordSize = StatRecorder::defaultMaxBytes;
+    bool explicitThreads = false, explicitKernel = false, explicitScheduler = false, explicitPinning = false;
     for (int i = 6; i < argc; ++i) {
         if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
             maxThreads = std::stoi(argv[++i]);
+            explicitThreads = true;
         } else if (std::strcmp(argv[i], "--batch-size") == 0 && i + 1 < argc) {
             batchSize = std::stoll(argv[++i]);
         } else if (std::strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
             deviceId = std::stoi(argv[++i]);
         } else if (std::strcmp(argv[i], "--platform") == 0 && i + 1 < argc) {
             platform = argv[++i];
+        } else if (std::strcmp(argv[i], "--gpu-backend") == 0 && i + 1 < argc) {
+            gpuBackend = argv[++i];
+        } else if (std::strcmp(argv[i], "--top-k") == 0 && i + 1 < argc) {
+            topCount = std::stoul(argv[++i]);
+        } else if (std::strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            kernel = argv[++i];
+            explicitKernel = true;
+        } else if (std::strcmp(argv[i], "--scheduler") == 0 && i + 1 < argc) {
+            scheduler = argv[++i];
+            explicitScheduler = true;
+        } else if (std::strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            pinning = argv[++i];
+            explicitPinning = true;
+        } else if (std::strcmp(argv[i], "--no-profile") == 0) {
+            useProfile = false;
+        } else if (std::strcmp(argv[i], "--psi-target") == 0 && i + 1 < argc) {
+            psiTarget = std::stod(argv[++i]);
+        } else if (std::strcmp(argv[i], "--psi-memory") == 0) {
+            psiMemory = true;
+        } else if (std::strcmp(argv[i], "--thermal-target") == 0 && i + 1 < argc) {
+            thermalTarget = std::stod(argv[++i]);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--record-size") == 0 && i + 1 < argc) {
+            recordSize = static_cast<std::uint64_t>(std::stod(argv[++i]) * (1 << 20));
+        } else if (std::strcmp(argv[i], "--template") == 0 && i + 1 < argc) {
+            templateSpec = argv[++i];
         }  else if (std::strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
         } else if (std::strcmp(argv[i], "--gpu") == 0) {
-        #if GPU == GPU_CUDA || GPU == GPU_OPENCL
             gpu = true;
-        #else
-            std::cerr << "GPU support not enabled in this build.\n";
+        }
+    }
+
+    // CPU builds load GPU backends at runtime: --gpu runs the first one with a usable
+    // device in the fixed order of gpuBackends.
+    #if GPU == GPU_NONE
+    std::vector<GpuBackend> backends;
+    const GpuBackend* backend = nullptr;
+    if (gpu) {
+        backends = loadGpuBackends(platform.empty() ? nullptr : platform.c_str());
+        backend = selectGpuBackend(backends, gpuBackend);
+        if (!backend) {
+            std::cerr << "No usable GPU backend" << (gpuBackend.empty() ? "" : " " + gpuBackend) << ":\n";
+            for (const auto& candidate : backends) {
+                std::cerr << "    " << candidate.name << ": " << (candidate.execute ? std::to_string(candidate.devices) + " devices" : candidate.path) << "\n";
+            }
             return 1;
-        #endif
         }
     }
+    #endif
+
+    // The host profile written by --autotune-cpu fills in whatever was not given explicitly.
+    CpuProfile profile;
+    if (!gpu && useProfile && loadProfile(profile)) {
+        kernel = explicitKernel ? kernel : profile.kernel;
+        scheduler = explicitScheduler ? scheduler : profile.scheduler;
+        maxThreads = explicitThreads ? maxThreads : profile.threads;
+        pinning = explicitPinning ? pinning : profile.pinning;
+        if (verbose) {
+            std::cout << "[CPU] Profile " << profilePath() << ": " << kernel << "/" << scheduler
+                      << " threads: " << maxThreads << " pinning: " << pinning << std::endl;
+        }
+    }
+    if (std::find(std::begin(pinningPolicies), std::end(pinningPolicies), pinning) == std::end(pinningPolicies)) {
+        std::cerr << "Unknown --pin " << pinning << ".\n";
+        return 1;
+    }
 
+    const EngineEntry* engine = findEngine(kernel, scheduler, topCount > 0 ? KeepTopK::name : FirstHit::name);
+    if (!gpu && !engine) {
+        std::cerr << "Unknown --kernel " << kernel << " or --scheduler " << scheduler << ".\n";
+        return 1;
+    }
+
+    // KALE jobs are built by prepare(); other contracts are described with --template.
+    PowTemplate pow;
+    const std::map<std::string, std::string> templateArguments = {{"block", argv[1]}, {"hash", hash}, {"miner", miner}};
+    auto buildJob = [&](std::uint64_t startNonce) {
+        Job job;
+        if (templateSpec.empty()) {
+            job.data = prepare(block, startNonce, hash, miner, job.nonceOffset);
+        } else {
+            pow.compile(templateArguments, startNonce, job);
+        }
+        job.difficulty = difficulty;
+        job.startNonce = startNonce;
+        job.batchSize = batchSize;
+        return job;
+    };
     try {
-        std::thread monitorThread([=]() { monitorHashRate(verbose, gpu); });
-        std::pair<std::vector<std::uint8_t>, std::uint64_t> result;
+        if (!templateSpec.empty()) {
+            pow = PowTemplate::parse(templateSpec);
+            Job job = buildJob(nonce);
+            if (gpu && (job.nonceWidth != 8 || job.pad != 0x01 || job.belowTarget)) {
+                std::cerr << "GPU kernels only support 8-byte nonces, Keccak-256 and target=zeros.\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid --template: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Adaptive worker gating under host CPU (and memory) pressure and temperature. Shared with
+    // the detached monitor, which steps the governors.
+    auto gate = std::make_shared<WorkerGate>(maxThreads);
+    std::vector<std::shared_ptr<Governor>> governors;
+    if (!gpu && psiTarget > 0) {
+        auto governor = std::make_shared<PressureGovernor>(gate, maxThreads, psiTarget, psiMemory);
+        if (governor->available()) {
+            governors.push_back(governor);
+        } else {
+            std::cerr << "Pressure stall information (/proc/pressure) is not available, --psi-target ignored.\n";
+        }
+    }
+    if (!gpu && thermalTarget > 0) {
+        auto governor = std::make_shared<ThermalGovernor>(gate, maxThreads, thermalTarget);
+        if (governor->available()) {
+            governors.push_back(governor);
+        } else {
+            std::cerr << "No thermal zones in /sys/class/thermal, --thermal-target ignored.\n";
+        }
+    }
+
+    // Per-second statistics on disk (recorder.h), sampled by the monitor.
+    std::shared_ptr<StatRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder = std::make_shared<StatRecorder>(recordPath, recordSize, static_cast<std::uint32_t>(block), gpu ? 0 : maxThreads,
+            governors.empty() ? nullptr : gate);
+        if (!recorder->open()) {
+            std::cerr << "Cannot open --record file " << recordPath << ".\n";
+            return 1;
+        }
+    }
+
+    try {
+        std::thread monitorThread([=]() { monitorHashRate(verbose, gpu, governors, recorder); });
+        Outcome outcome;
+        outcome.best = TopK(topCount);
         if (gpu) {
             #if GPU == GPU_CUDA
                 std::cout << "[GPU] CUDA" << std::endl;
             #elif GPU == GPU_OPENCL
                 std::cout << "[GPU] OpenCL" << std::endl;
+            #elif GPU == GPU_VULKAN
+                std::cout << "[GPU] Vulkan" << std::endl;
+            #else
+                std::cout << "[GPU] " << backend->label << " (" << backend->path << ")" << std::endl;
             #endif
-            #if GPU == GPU_CUDA || GPU == GPU_OPENCL
             std::uint64_t currentNonce = nonce;
             bool showDeviceInfo = verbose;
             while (!found.load()) {
-                size_t nonceOffset = 0;
-                std::vector<std::uint8_t> data = prepare(block, currentNonce, hash, miner, nonceOffset);
+                Job job = buildJob(currentNonce);
+                const std::vector<std::uint8_t>& data = job.data;
+                size_t nonceOffset = job.nonceOffset;
                 std::vector<std::uint8_t> input(data.size());
                 std::memcpy(input.data(), data.data(), data.size());
                 std::vector<std::uint8_t> output(32);
                 std::uint64_t validNonce = 0;
                 if (verbose) {
-                    std::cout << "[GPU] Mining batch: " << nonce << " block: " << block
-                              << " difficulty: " << difficulty << " hash: " << hash << std::endl;
-                    std::cout.flush();
+                    AsyncLog::instance().write("[GPU] Mining batch: %llu %s", nonce, "block: " + std::to_string(block)
+                        + " difficulty: " + std::to_string(difficulty) + " hash: " + hash);
                 }
                 auto gpuStartTime = std::chrono::high_resolution_clock::now();
-                #if GPU == GPU_CUDA
+                #if GPU == GPU_CUDA || GPU == GPU_VULKAN
                 int res = executeKernel(deviceId, input.data(), data.size(), currentNonce, nonceOffset,
                                             batchSize, difficulty, maxThreads, output.data(), &validNonce, showDeviceInfo);
                 #elif GPU == GPU_OPENCL
                 int res = executeKernel(platform.empty() ? nullptr : platform.c_str(), deviceId, input.data(), data.size(), currentNonce, nonceOffset,
                                              batchSize, difficulty, maxThreads, output.data(), &validNonce, showDeviceInfo);
+                #else
+                int res = backend->execute(platform.empty() ? nullptr : platform.c_str(), deviceId, input.data(), data.size(), currentNonce, nonceOffset,
+                                             batchSize, difficulty, maxThreads, output.data(), &validNonce, showDeviceInfo);
                 #endif
                 showDeviceInfo = false;
                 auto gpuEndTime = std::chrono::high_resolution_clock::now();
@@ -224,55 +935,49 @@ int main(int argc, char* argv[]) {
                 hashMetric.store(batchSize / elapsedTime.count());
                 if (res == 1) {
                     found.store(true);
-                    result.first.assign(output.begin(), output.end());
-                    result.second = validNonce;
+                    outcome.found = true;
+                    std::copy(output.begin(), output.end(), outcome.hash.begin());
+                    outcome.nonce = validNonce;
+                    outcome.best.push(output.data(), validNonce);
                     break;
                 }
                 currentNonce += batchSize;
             }
-            #endif
         } else {
-            std::uint64_t currentNonce = nonce;
-            std::vector<std::thread> threads;
-            std::mutex resultMutex;
-            while (!found.load()) {
-                while (static_cast<int>(threads.size()) < maxThreads && !found.load()) {
-                    std::uint64_t endNonce = currentNonce + batchSize;
-                    threads.emplace_back([&, startNonce = currentNonce, endNonce]() {
-                        auto localResult = find(block, hash, startNonce, difficulty, miner, verbose, batchSize);
-                        if (!localResult.first.empty()) {
-                            std::lock_guard<std::mutex> lock(resultMutex);
-                            result = localResult;
-                            found.store(true);
-                        }
-                    });
-                    currentNonce = endNonce;
-                }
-                threads.erase(std::remove_if(threads.begin(), threads.end(),
-                    [](std::thread& t) {
-                        if (t.joinable()) {
-                            t.join();
-                            return true;
-                        }
-                        return false;
-                    }), threads.end());
-            }
+            Job job = buildJob(nonce);
+            job.description = "block: " + std::to_string(block) + " difficulty: " + std::to_string(difficulty) + " hash: " + hash;
+            EngineOptions options;
+            options.threads = maxThreads;
+            options.topCount = topCount;
+            options.verbose = verbose;
+            options.cpus = pinningCpus(pinning);
+            outcome = engine->mine(job, options, {found, hashMetric, governors.empty() ? nullptr : gate.get(),
+                recorder ? recorder->workerHashes() : nullptr});
+        }
 
-            for (auto& t : threads) {
-                if (t.joinable()) {
-                    t.join();
-                }
-            }
+        if (recorder) {
+            recorder->finish(outcome.found, outcome.found ? leadingZeros(outcome.hash.data()) : 0);
         }
 
-        if (!result.first.empty()) {
+        if (verbose) {
+            AsyncLog::instance().flush();
+        }
+        if (outcome.found) {
             std::cout << "{\n"
-                      << "  \"hash\": \"";
-            for (const auto& byte : result.first) {
-                std::printf("%02x", byte);
+                      << "  \"hash\": \"" << toHex(outcome.hash.data(), 32) << "\",\n"
+                      << "  \"nonce\": " << outcome.nonce;
+            if (topCount > 0) {
+                std::cout << ",\n  \"top\": [";
+                auto candidates = outcome.best.sorted();
+                for (size_t i = 0; i < candidates.size(); ++i) {
+                    // Entries are [hash, nonce, zeros] arrays: homestead extracts the first {...} block.
+                    std::cout << (i ? "," : "") << "\n    [\"" << toHex(candidates[i].hash.data(), 32)
+                              << "\", " << candidates[i].nonce
+                              << ", " << leadingZeros(candidates[i].hash.data()) << "]";
+                }
+                std::cout << "\n  ]";
             }
-            std::cout << "\",\n"
-                      << "  \"nonce\": " << result.second << "\n"
+            std::cout << "\n"
                       << "}\n";
         } else {
             std::cout << "No valid hash found.\n";
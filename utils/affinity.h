@@ -0,0 +1,144 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    CPU topology and worker pinning. Pinning policies order the logical CPUs workers are bound
+    to: "compact" fills SMT siblings of a core before the next core, "scatter" takes one thread
+    per physical core first. Linux only; elsewhere topology is flat and pinning is a no-op.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+struct CpuTopology {
+    std::vector<int> compact;
+    std::vector<int> scatter;
+    int physicalCores = 1;
+    std::string model = "unknown";
+    std::string microcode = "unknown";
+};
+
+// Parses kernel CPU lists such as "0-3,8,10-11".
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+        }
+    }
+    return cpus;
+}
+
+inline std::string readFirstLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+inline const CpuTopology& cpuTopology() {
+    static const CpuTopology topology = []() {
+        CpuTopology result;
+        std::vector<int> cpus = parseCpuList(readFirstLine("/sys/devices/system/cpu/online"));
+        if (cpus.empty()) {
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+        // Siblings grouped per (package, core), cores in order of their first logical CPU.
+        std::map<std::pair<int, int>, size_t> coreIndex;
+        std::vector<std::vector<int>> cores;
+        for (int cpu : cpus) {
+            std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            std::string core = readFirstLine(base + "core_id");
+            std::string package = readFirstLine(base + "physical_package_id");
+            std::pair<int, int> key(package.empty() ? 0 : std::stoi(package), core.empty() ? cpu : std::stoi(core));
+            auto it = coreIndex.find(key);
+            if (it == coreIndex.end()) {
+                it = coreIndex.emplace(key, cores.size()).first;
+                cores.emplace_back();
+            }
+            cores[it->second].push_back(cpu);
+        }
+        for (const auto& siblings : cores) {
+            result.compact.insert(result.compact.end(), siblings.begin(), siblings.end());
+        }
+        for (size_t thread = 0; result.scatter.size() < result.compact.size(); ++thread) {
+            for (const auto& siblings : cores) {
+                if (thread < siblings.size()) {
+                    result.scatter.push_back(siblings[thread]);
+                }
+            }
+        }
+        result.physicalCores = static_cast<int>(cores.size());
+
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos || colon + 2 > line.size()) {
+                continue;
+            }
+            std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            std::string value = line.substr(colon + 2);
+            if ((key == "model name" || key == "Hardware") && result.model == "unknown") {
+                result.model = value;
+            } else if (key == "microcode" && result.microcode == "unknown") {
+                result.microcode = value;
+            } else if (key == "CPU part" && result.model == "unknown") {
+                result.model = "CPU part " + value;
+            }
+        }
+        return result;
+    }();
+    return topology;
+}
+
+inline const char* pinningPolicies[] = {"none", "compact", "scatter"};
+
+// Logical CPUs for a pinning policy, empty for "none" or an unknown policy.
+inline std::vector<int> pinningCpus(const std::string& policy) {
+    if (policy == "compact") {
+        return cpuTopology().compact;
+    }
+    if (policy == "scatter") {
+        return cpuTopology().scatter;
+    }
+    return {};
+}
+
+inline bool pinCurrentThread(int cpu) {
+    #if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    #else
+    (void)cpu;
+    return false;
+    #endif
+}
@@ -0,0 +1,207 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    CPU auto-tuner. Short benchmark trials search kernel x scheduler, then thread count, then
+    pinning, dropping options that are dominated at each stage. The winner is stored as a
+    per-host profile keyed on CPU model and microcode, which normal runs load automatically when it
+    was tuned for the same Keccak implementation and SIMD width as the running build.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "misc.h"
+#include "engine.h"
+#include "affinity.h"
+
+// Runs one engine configuration for `seconds` and returns its hash rate.
+inline double measureEngine(const EngineEntry& entry, const Job& job, const EngineOptions& options, double seconds) {
+    std::atomic<bool> stop(false);
+    std::atomic<std::uint64_t> hashes(0);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::thread timer([&]() {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop.store(true);
+    });
+    entry.mine(job, options, {stop, hashes});
+    timer.join();
+    std::chrono::duration<double> elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+    return hashes.load() / elapsedTime.count();
+}
+
+struct CpuProfile {
+    std::string kernel;
+    std::string scheduler;
+    std::string pinning = "none";
+    int threads = 1;
+    double hashRate = 0;
+};
+
+// $KALE_MINER_PROFILE_DIR (default ~/.kale-miner)/cpu-<fnv1a(model, microcode)>.json
+inline std::string profilePath() {
+    const CpuTopology& topology = cpuTopology();
+    std::uint64_t key = 0xcbf29ce484222325ULL;
+    for (char c : topology.model + "\n" + topology.microcode) {
+        key = (key ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+    }
+    std::string dir;
+    if (const char* env = std::getenv("KALE_MINER_PROFILE_DIR")) {
+        dir = env;
+    } else if (const char* home = std::getenv("HOME")) {
+        dir = std::string(home) + "/.kale-miner";
+    } else if (const char* profile = std::getenv("USERPROFILE")) {
+        dir = std::string(profile) + "/.kale-miner";
+    } else {
+        dir = ".kale-miner";
+    }
+    std::ostringstream path;
+    path << dir << "/cpu-" << std::hex << std::setw(16) << std::setfill('0') << key << ".json";
+    return path.str();
+}
+
+inline std::string profileJson(const CpuProfile& profile) {
+    const CpuTopology& topology = cpuTopology();
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(2)
+         << "{\"model\": \"" << topology.model << "\", \"microcode\": \"" << topology.microcode
+         << "\", \"kernel\": \"" << profile.kernel << "\", \"scheduler\": \"" << profile.scheduler
+         << "\", \"threads\": " << profile.threads << ", \"pinning\": \"" << profile.pinning
+         << "\", \"hashrate\": " << profile.hashRate << ", \"keccak\": " << KECCAK
+         << ", \"lanes\": " << KECCAK_LANES << "}";
+    return json.str();
+}
+
+inline std::string profileField(const std::string& json, const std::string& key) {
+    size_t at = json.find("\"" + key + "\":");
+    if (at == std::string::npos) {
+        return "";
+    }
+    at = json.find_first_not_of(" \"", at + key.size() + 3);
+    size_t end = json.find_first_of("\",}", at);
+    return at == std::string::npos ? "" : json.substr(at, end - at);
+}
+
+inline bool loadProfile(CpuProfile& profile, const std::string& path = profilePath()) {
+    std::ifstream file(path);
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CpuProfile loaded;
+    loaded.kernel = profileField(json, "kernel");
+    loaded.scheduler = profileField(json, "scheduler");
+    loaded.pinning = profileField(json, "pinning");
+    try {
+        loaded.threads = std::stoi(profileField(json, "threads"));
+        loaded.hashRate = std::stod(profileField(json, "hashrate"));
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (!findEngine(loaded.kernel, loaded.scheduler, FirstHit::name) || loaded.threads < 1) {
+        return false;
+    }
+    // A profile tuned for another Keccak implementation or SIMD width does not apply to this build.
+    std::string keccak = profileField(json, "keccak");
+    std::string lanes = profileField(json, "lanes");
+    if (keccak != std::to_string(KECCAK) || lanes != std::to_string(KECCAK_LANES)) {
+        std::cerr << "[CPU] Ignoring profile " << path << ": tuned for KECCAK=" << keccak << " with " << lanes
+                  << " lanes, this build uses KECCAK=" << KECCAK << " with " << KECCAK_LANES
+                  << " lanes. Re-run --autotune-cpu." << std::endl;
+        return false;
+    }
+    profile = loaded;
+    return true;
+}
+
+inline bool saveProfile(const CpuProfile& profile, const std::string& path = profilePath()) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::ofstream file(path);
+    file << profileJson(profile) << std::endl;
+    return static_cast<bool>(file);
+}
+
+inline CpuProfile autotuneCpu(const Job& job, int maxThreads, double seconds) {
+    // Options within `keep` of the best survive a stage; a later candidate (more threads, pinning)
+    // must beat the current pick by `margin` to replace it, so trial noise does not flip choices.
+    static const double keep = 0.95;
+    static const double margin = 1.02;
+    auto trial = [&](const EngineEntry& entry, int threads, const std::string& pinning) {
+        EngineOptions options;
+        options.threads = threads;
+        options.cpus = pinningCpus(pinning);
+        double hashRate = measureEngine(entry, job, options, seconds);
+        std::cerr << "[AUTOTUNE] " << entry.kernel << "/" << entry.scheduler << " threads: " << threads
+                  << " pinning: " << pinning << " " << formatHashRate(hashRate) << std::endl;
+        return hashRate;
+    };
+
+    // Stage 1: kernel x scheduler at full width.
+    std::vector<std::pair<const EngineEntry*, double>> combos;
+    double best = 0;
+    for (const auto& entry : engineRegistry()) {
+        if (std::strcmp(entry.result, FirstHit::name) == 0) {
+            combos.emplace_back(&entry, trial(entry, maxThreads, "none"));
+            best = std::max(best, combos.back().second);
+        }
+    }
+
+    // Stage 2: thread counts for the survivors, stopping once adding workers stops paying off.
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(std::min(cpuTopology().physicalCores, maxThreads));
+    counts.push_back(maxThreads);
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    CpuProfile profile;
+    for (const auto& [entry, hashRate] : combos) {
+        if (hashRate < best * keep) {
+            continue;
+        }
+        double comboBest = 0;
+        for (int threads : counts) {
+            double rate = threads == maxThreads ? hashRate : trial(*entry, threads, "none");
+            if (rate > profile.hashRate * margin) {
+                profile = {entry->kernel, entry->scheduler, "none", threads, rate};
+            }
+            if (rate < comboBest * keep) {
+                break;
+            }
+            comboBest = std::max(comboBest, rate);
+        }
+    }
+
+    // Stage 3: pinning policy for the winner. Nothing measured leaves an empty profile
+    // (hashRate 0), which the caller rejects.
+    const EngineEntry* winner = findEngine(profile.kernel, profile.scheduler, FirstHit::name);
+    if (!winner || profile.hashRate <= 0) {
+        return profile;
+    }
+    for (const char* pinning : pinningPolicies) {
+        if (std::strcmp(pinning, "none") != 0) {
+            double rate = trial(*winner, profile.threads, pinning);
+            if (rate > profile.hashRate * margin) {
+                profile.pinning = pinning;
+                profile.hashRate = rate;
+            }
+        }
+    }
+    return profile;
+}
@@ -0,0 +1,115 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Runtime-loaded GPU backends for CPU builds. `make plugins` builds libkale-<name>.so from the
+    CUDA, OpenCL and Vulkan sources; each exports kaleBackendProbe (usable device count, never
+    exits) and kaleBackendExecute (the executeKernel batch entry point). A plugin whose runtime
+    (libcuda, libOpenCL, libvulkan) is missing fails to load and is simply skipped, so one binary
+    runs on CPU-only hosts and elsewhere uses the first usable backend in a fixed preference order.
+    Backends are not timed against each other.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <limits.h>
+#include <unistd.h>
+#endif
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+extern "C" {
+typedef int (*BackendProbeFn)(const char* platform);
+typedef int (*BackendExecuteFn)(const char* platform, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce,
+    int nonceOffset, std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce,
+    bool showDeviceInfo);
+}
+
+struct GpuBackend {
+    const char* name;
+    const char* label;
+    std::string path;   // Loaded library, or the loader error.
+    int devices = 0;
+    BackendExecuteFn execute = nullptr;
+};
+
+// Preference order for selectGpuBackend: CUDA, then OpenCL, then Vulkan, which is usually the
+// fastest first on the same device (see the GPU benchmarks in the README). Nothing is measured.
+inline const GpuBackend gpuBackends[] = {{"cuda", "CUDA"}, {"opencl", "OpenCL"}, {"vulkan", "Vulkan"}};
+
+inline std::string executableDir() {
+    #if defined(__linux__)
+    char path[PATH_MAX];
+    ssize_t size = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    std::string exe = size > 0 ? std::string(path, size) : "";
+    #elif defined(__APPLE__)
+    char path[PATH_MAX];
+    uint32_t size = sizeof(path);
+    std::string exe = _NSGetExecutablePath(path, &size) == 0 ? std::string(path) : "";
+    #else
+    std::string exe;
+    #endif
+    size_t slash = exe.find_last_of('/');
+    return slash == std::string::npos ? "." : exe.substr(0, slash);
+}
+
+// Loads every plugin found next to the executable (or on the library path) and probes it.
+// Plugins stay loaded for the life of the process.
+inline std::vector<GpuBackend> loadGpuBackends(const char* platform) {
+    std::vector<GpuBackend> backends;
+    #if defined(__linux__) || defined(__APPLE__)
+    #if defined(__APPLE__)
+    const char* extension = ".dylib";
+    #else
+    const char* extension = ".so";
+    #endif
+    for (GpuBackend backend : gpuBackends) {
+        std::string file = std::string("libkale-") + backend.name + extension;
+        void* handle = nullptr;
+        for (const std::string& path : {executableDir() + "/" + file, file}) {
+            if ((handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) != nullptr) {
+                backend.path = path;
+                break;
+            }
+            // Keep the first real failure (e.g. the plugin is there but libOpenCL is not).
+            const char* error = dlerror();
+            if (backend.path.empty() && access(path.c_str(), F_OK) == 0) {
+                backend.path = error ? error : path;
+            }
+        }
+        if (!handle) {
+            backend.path = backend.path.empty() ? file + " not found" : backend.path;
+            backends.push_back(backend);
+            continue;
+        }
+        auto probe = reinterpret_cast<BackendProbeFn>(dlsym(handle, "kaleBackendProbe"));
+        backend.execute = reinterpret_cast<BackendExecuteFn>(dlsym(handle, "kaleBackendExecute"));
+        backend.devices = probe && backend.execute ? probe(platform) : 0;
+        backends.push_back(backend);
+    }
+    #else
+    (void)platform;
+    #endif
+    return backends;
+}
+
+// The requested backend, or the first one in gpuBackends order with a usable device; nullptr when
+// none qualifies.
+inline const GpuBackend* selectGpuBackend(const std::vector<GpuBackend>& backends, const std::string& requested) {
+    for (const auto& backend : backends) {
+        if ((requested.empty() || requested == backend.name) && backend.devices > 0) {
+            return &backend;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,107 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Online kernel selection (--kernel adaptive). Each worker runs a discounted UCB1 bandit over
+    the CPU kernels, rewarded by the measured hash rate of each range it hashes. Old samples
+    fade (discount), so an arm left alone regains exploration bonus and is probed again now and
+    then (about one range in 20 when it is half as fast); the preferred kernel follows frequency
+    licenses, temperature and SMT co-runners of the core the worker runs on.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class KernelBandit {
+    public:
+        static constexpr int maxArms = 4;
+
+        KernelBandit(int workers, int arms, int defaultArm, double discount = 0.95, double exploration = 0.2)
+            : arms(arms), defaultArm(defaultArm), discount(discount), exploration(exploration), workers(workers) {
+            for (auto& state : this->workers) {
+                state.preferred = defaultArm;
+            }
+        }
+
+        // Arm for the worker's next range: each arm once, then the best upper confidence bound.
+        int choose(int worker) const {
+            const Worker& state = workers[worker];
+            double total = 0, fastest = 0;
+            for (int arm = 0; arm < arms; ++arm) {
+                if (state.count[arm] == 0) {
+                    return arm;
+                }
+                total += state.count[arm];
+                fastest = std::max(fastest, state.rate(arm));
+            }
+            int best = 0;
+            double bestBound = -1;
+            for (int arm = 0; arm < arms; ++arm) {
+                double bound = state.rate(arm) / fastest + exploration * std::sqrt(std::log(total) / state.count[arm]);
+                if (bound > bestBound) {
+                    best = arm;
+                    bestBound = bound;
+                }
+            }
+            return best;
+        }
+
+        // Records a completed range; returns true when the worker's fastest arm changed.
+        bool record(int worker, int arm, double hashes, double seconds) {
+            Worker& state = workers[worker];
+            for (int a = 0; a < arms; ++a) {
+                state.count[a] *= discount;
+                state.sum[a] *= discount;
+            }
+            state.count[arm] += 1;
+            state.sum[arm] += hashes / std::max(seconds, 1e-9);
+            for (int a = 0; a < arms; ++a) {
+                if (state.count[a] == 0) {
+                    return false;
+                }
+            }
+            int fastest = preferred(worker);
+            bool switched = fastest != state.preferred;
+            state.preferred = fastest;
+            return switched;
+        }
+
+        // Fastest arm so far; the default arm until every arm has a sample.
+        int preferred(int worker) const {
+            const Worker& state = workers[worker];
+            int best = 0;
+            for (int arm = 0; arm < arms; ++arm) {
+                if (state.count[arm] == 0) {
+                    return defaultArm;
+                }
+                if (state.rate(arm) > state.rate(best)) {
+                    best = arm;
+                }
+            }
+            return best;
+        }
+
+        double rate(int worker, int arm) const { return workers[worker].rate(arm); }
+
+    private:
+        // Only touched by its own worker thread; padded against false sharing.
+        struct alignas(64) Worker {
+            double count[maxArms] = {};
+            double sum[maxArms] = {};
+            int preferred = 0;
+
+            double rate(int arm) const { return count[arm] > 0 ? sum[arm] / count[arm] : 0; }
+        };
+
+        int arms;
+        int defaultArm;
+        double discount;
+        double exploration;
+        std::vector<Worker> workers;
+};
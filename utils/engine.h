@@ -0,0 +1,730 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Policy-based CPU mining engine. MiningEngine<Kernel, RangeScheduler, ResultPolicy> composes
+    a hashing kernel, a nonce range scheduler and a result policy at compile time, so each
+    combination is its own tight loop. engineRegistry() maps flag values to instantiations.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "keccak.h"
+#include "topk.h"
+#include "affinity.h"
+#include "logging.h"
+#include "bandit.h"
+
+static const int hashRateInterval = 5000;
+
+struct Job {
+    std::vector<std::uint8_t> data;
+    size_t nonceOffset = 0;
+    size_t nonceWidth = 8;
+    std::uint8_t pad = 0x01;
+    int difficulty = 0;
+    bool belowTarget = false;
+    std::array<std::uint8_t, 32> threshold{};
+    std::uint64_t startNonce = 0;
+    std::uint64_t batchSize = 0;
+    std::string description;
+};
+
+// Worker t is pinned to cpus[t % cpus.size()] when `cpus` is not empty (see affinity.h).
+struct EngineOptions {
+    int threads = 1;
+    size_t topCount = 0;
+    bool verbose = false;
+    std::vector<int> cpus;
+};
+
+// Caps the number of running workers. Each governor (pressure.h, thermal.h) sets its own limit
+// and the lowest one wins; workers at or above `active` idle at range boundaries. Below 100%,
+// `duty` makes each worker idle for the matching share of the time it spent on a range.
+struct WorkerGate {
+    enum Limit { pressureLimit, thermalLimit, limitCount };
+
+    explicit WorkerGate(int workers) : active(workers) {
+        for (auto& limit : limits) {
+            limit.store(workers);
+        }
+    }
+
+    int limit(Limit index) const { return limits[index].load(); }
+
+    void setLimit(Limit index, int workers) {
+        limits[index].store(workers);
+        int lowest = workers;
+        for (const auto& limit : limits) {
+            lowest = std::min(lowest, limit.load());
+        }
+        active.store(std::max(1, lowest));
+    }
+
+    std::atomic<int> active;
+    std::atomic<int> duty{100};
+    std::atomic<int> limits[limitCount];
+};
+
+// Periodic controller driving a WorkerGate; step() is called about once per second and returns
+// a telemetry line.
+class Governor {
+    public:
+        virtual ~Governor() = default;
+        virtual std::string step() = 0;
+};
+
+// Hashes done by one worker, for per-worker rates (recorder.h); padded against false sharing.
+struct alignas(64) WorkerCounter {
+    std::atomic<std::uint64_t> hashes{0};
+};
+
+// Shared with the hash rate monitor; setting `found` stops every worker. `workerHashes`, when
+// set, has one counter per worker.
+struct EngineContext {
+    std::atomic<bool>& found;
+    std::atomic<std::uint64_t>& hashMetric;
+    WorkerGate* gate = nullptr;
+    WorkerCounter* workerHashes = nullptr;
+};
+
+struct Outcome {
+    bool found = false;
+    std::array<std::uint8_t, 32> hash{};
+    std::uint64_t nonce = 0;
+    TopK best;
+};
+
+// Big-endian nonce of `width` bytes (the low bytes of `nonce`).
+static INLINE void storeNonce(std::uint8_t* dest, std::uint64_t nonce, size_t width = 8) {
+    for (size_t i = 0; i < width; ++i) {
+        dest[width - 1 - i] = static_cast<std::uint8_t>(nonce >> (i * 8));
+    }
+}
+
+static INLINE bool meetsDifficulty(const std::uint8_t* hash, int difficulty) {
+    int zeros = 0;
+    for (int i = 0; i < 32; ++i) {
+        zeros += (hash[i] == 0) ? 2 : ((hash[i] >> 4) == 0 ? 1 : 0);
+        if (hash[i] != 0 || zeros >= difficulty)
+            break;
+    }
+    return zeros >= difficulty;
+}
+
+static INLINE std::uint64_t byteSwap64(std::uint64_t x) {
+    #if defined(_MSC_VER)
+    return _byteswap_uint64(x);
+    #elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+    #else
+    x = ((x & 0x00ff00ff00ff00ffULL) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffULL);
+    x = ((x & 0x0000ffff0000ffffULL) << 16) | ((x >> 16) & 0x0000ffff0000ffffULL);
+    return (x << 32) | (x >> 32);
+    #endif
+}
+
+// Message layouts. FixedLayout pins the size and nonce position at compile time, with an 8-byte
+// nonce and Keccak-256 padding (KaleLayout is the 76-byte block/nonce/entropy/miner message).
+// DynamicLayout passes the job's values through.
+template<size_t Size, size_t NonceOffset>
+struct FixedLayout {
+    static constexpr size_t size(size_t) { return Size; }
+    static constexpr size_t nonceOffset(size_t) { return NonceOffset; }
+    static constexpr size_t nonceWidth(size_t) { return 8; }
+    static constexpr std::uint8_t pad(std::uint8_t) { return 0x01; }
+    static bool matches(const Job& job) {
+        return job.data.size() == Size && job.nonceOffset == NonceOffset && job.nonceWidth == 8 && job.pad == 0x01;
+    }
+};
+
+using KaleLayout = FixedLayout<76, 4>;
+
+struct DynamicLayout {
+    static size_t size(size_t size) { return size; }
+    static size_t nonceOffset(size_t offset) { return offset; }
+    static size_t nonceWidth(size_t width) { return width; }
+    static std::uint8_t pad(std::uint8_t pad) { return pad; }
+    static bool matches(const Job&) { return true; }
+};
+
+// Difficulty as masks over the little-endian 64-bit words of the hash: the first `difficulty`
+// nibbles are zero iff (word[w] & mask[w]) == 0 for every word. `threshold` is the job's
+// big-endian target for BelowTarget.
+struct Target {
+    std::uint64_t mask[4] = {};
+    std::array<std::uint8_t, 32> threshold{};
+
+    explicit Target(int difficulty) {
+        for (int nibble = 0; nibble < difficulty && nibble < 64; ++nibble) {
+            mask[nibble / 16] |= 0xF0ULL << (((nibble / 2) % 8) * 8) >> ((nibble & 1) * 4);
+        }
+    }
+
+    explicit Target(const Job& job) : Target(job.difficulty) {
+        threshold = job.threshold;
+    }
+};
+
+// Difficulty tiers: up to MaxNibbles the check is one mask compare per hash word (a single
+// 32-bit compare for <= 8 nibbles, one 64-bit compare on lane 0 for <= 16).
+template<int MaxNibbles>
+struct DifficultyTier {
+    static constexpr int words = (MaxNibbles + 15) / 16;
+
+    static bool accepts(int difficulty) { return difficulty <= MaxNibbles; }
+
+    static INLINE bool meets(const std::uint8_t* hash, const Target& target, int) {
+        if constexpr (MaxNibbles <= 8) {
+            std::uint32_t word;
+            std::memcpy(&word, hash, sizeof(word));
+            return (word & static_cast<std::uint32_t>(target.mask[0])) == 0;
+        } else {
+            for (int w = 0; w < words; ++w) {
+                if ((loadLane(hash + w * 8) & target.mask[w]) != 0)
+                    return false;
+            }
+            return true;
+        }
+    }
+};
+
+// Template jobs with target=below:<hex> accept hashes strictly below the big-endian threshold.
+struct BelowTarget {
+    static INLINE bool meets(const std::uint8_t* hash, const Target& target, int) {
+        return std::memcmp(hash, target.threshold.data(), 32) < 0;
+    }
+};
+
+// Fallback for difficulties beyond the 64 nibbles of a hash (benchmark, never met).
+struct AnyDifficulty {
+    static bool accepts(int) { return true; }
+
+    static INLINE bool meets(const std::uint8_t* hash, const Target&, int difficulty) {
+        return meetsDifficulty(hash, difficulty);
+    }
+};
+
+// Messages shorter than the Keccak-256 rate are one block. `words` receives it as little-endian
+// state words with the nonce zeroed and the padding applied; kernels XOR each nonce in.
+static constexpr size_t blockWords = 136 / 8;
+
+static void absorbBlock(const Job& job, std::uint64_t* words) {
+    alignas(64) std::uint8_t block[blockWords * 8] = {};
+    std::memcpy(block, job.data.data(), job.data.size());
+    std::memset(block + job.nonceOffset, 0, job.nonceWidth);
+    block[job.data.size()] ^= job.pad;
+    block[sizeof(block) - 1] ^= 0x80;
+    for (size_t w = 0; w < blockWords; ++w) {
+        words[w] = loadLane(block + w * 8);
+    }
+}
+
+// Kernel policies hash `width` consecutive nonces per call.
+template<class Layout>
+class ScalarKernel {
+    public:
+        static constexpr size_t width = 1;
+        static constexpr const char* name = "scalar";
+
+        explicit ScalarKernel(const Job& job)
+            : data(job.data), nonceOffset(job.nonceOffset), nonceWidth(job.nonceWidth), keccak(Layout::pad(job.pad)) {}
+
+        INLINE void hash(std::uint64_t nonce, std::uint8_t (*hashes)[32]) {
+            storeNonce(data.data() + Layout::nonceOffset(nonceOffset), nonce, Layout::nonceWidth(nonceWidth));
+            keccak.reset();
+            keccak.update(data.data(), Layout::size(data.size()));
+            keccak.finalize(hashes[0]);
+        }
+
+    private:
+        std::vector<std::uint8_t> data;
+        size_t nonceOffset;
+        size_t nonceWidth;
+        Keccak256 keccak;
+};
+
+// Single-block messages (< 136 bytes) keep the absorbed block as pre-splatted state words, so a
+// hash only XORs the byte-swapped nonce into the one or two words holding it. Longer messages go
+// through keccak256xN.
+template<class Layout>
+class MultiBufferKernel {
+    public:
+        static constexpr size_t width = KECCAK_LANES;
+        static constexpr const char* name = "multibuffer";
+        static constexpr size_t rate = 136;
+
+        explicit MultiBufferKernel(const Job& job)
+            : size(job.data.size()), nonceOffset(job.nonceOffset), nonceWidth(job.nonceWidth), pad(job.pad),
+              singleBlock(job.data.size() < rate) {
+            if (singleBlock) {
+                std::uint64_t words[blockWords];
+                absorbBlock(job, words);
+                load(words);
+                return;
+            }
+            lanes.resize(width * size);
+            for (size_t l = 0; l < width; ++l) {
+                std::memcpy(lanes.data() + l * size, job.data.data(), size);
+                inputs[l] = lanes.data() + l * size;
+            }
+        }
+
+        // Switches a single-block kernel to another message of the same layout (absorbBlock
+        // words) without allocating; used by the daemon job store (jobstore.h).
+        INLINE void load(const std::uint64_t* words) {
+            for (size_t w = 0; w < blockWords; ++w) {
+                base[w] = splatLanes(words[w]);
+            }
+        }
+
+        INLINE void hash(std::uint64_t nonce, std::uint8_t (*hashes)[32]) {
+            if (Layout::size(size) < rate && singleBlock) {
+                hashBlock(nonce, hashes);
+                return;
+            }
+            std::uint8_t* outputs[width];
+            for (size_t l = 0; l < width; ++l) {
+                storeNonce(lanes.data() + l * size + nonceOffset, nonce + l, nonceWidth);
+                outputs[l] = hashes[l];
+            }
+            keccak256xN(inputs, size, outputs, pad);
+        }
+
+    private:
+        size_t size;
+        size_t nonceOffset;
+        size_t nonceWidth;
+        std::uint8_t pad;
+        bool singleBlock;
+        keccak_lanes_t base[rate / 8];
+        std::vector<std::uint8_t> lanes;
+        const std::uint8_t* inputs[width];
+
+        static INLINE keccak_lanes_t splatLanes(std::uint64_t value) {
+            keccak_lanes_t lanes;
+            for (size_t l = 0; l < width; ++l) {
+                lanes[l] = value;
+            }
+            return lanes;
+        }
+
+        INLINE void hashBlock(std::uint64_t nonce, std::uint8_t (*hashes)[32]) {
+            const size_t offset = Layout::nonceOffset(nonceOffset);
+            const size_t word = offset / 8;
+            const int shift = static_cast<int>(offset % 8) * 8;
+            const int unused = static_cast<int>(8 - Layout::nonceWidth(nonceWidth)) * 8;
+            keccak_lanes_t nonces;
+            for (size_t l = 0; l < width; ++l) {
+                nonces[l] = byteSwap64((nonce + l) << unused);
+            }
+            keccak_lanes_t s[25];
+            for (size_t w = 0; w < rate / 8; ++w) {
+                s[w] = base[w];
+            }
+            for (size_t w = rate / 8; w < 25; ++w) {
+                s[w] = splatLanes(0);
+            }
+            s[word] ^= nonces << shift;
+            if (shift != 0) {
+                s[word + 1] ^= nonces >> (64 - shift);
+            }
+            keccakF1600xN(s);
+            for (size_t l = 0; l < width; ++l) {
+                for (size_t w = 0; w < 4; ++w) {
+                    storeLane(hashes[l] + w * 8, s[w][l]);
+                }
+            }
+        }
+};
+
+// Experimental: KECCAK_LANES vector states plus `Scalars` scalar states hashed in one round
+// loop (keccakF1600xNHybrid) to keep both the SIMD and the scalar pipelines busy. Nonces
+// nonce..nonce+KECCAK_LANES-1 go to the vector lanes, the next ones to the scalar states.
+// Messages of a block or more hash the two groups separately.
+template<class Layout, size_t Scalars>
+class HybridKernel {
+    public:
+        static constexpr size_t lanes = KECCAK_LANES;
+        static constexpr size_t width = lanes + Scalars;
+        static constexpr const char* name = Scalars == 1 ? "hybrid" : "hybrid2";
+        static constexpr size_t rate = 136;
+
+        explicit HybridKernel(const Job& job)
+            : vector(job), data(job.data), nonceOffset(job.nonceOffset), nonceWidth(job.nonceWidth),
+              singleBlock(job.data.size() < rate), keccak(Layout::pad(job.pad)) {
+            if (singleBlock) {
+                absorbBlock(job, base);
+            }
+        }
+
+        INLINE void hash(std::uint64_t nonce, std::uint8_t (*hashes)[32]) {
+            if (!(Layout::size(data.size()) < rate && singleBlock)) {
+                vector.hash(nonce, hashes);
+                for (size_t k = 0; k < Scalars; ++k) {
+                    storeNonce(data.data() + nonceOffset, nonce + lanes + k, nonceWidth);
+                    keccak.reset();
+                    keccak.update(data.data(), data.size());
+                    keccak.finalize(hashes[lanes + k]);
+                }
+                return;
+            }
+            const size_t offset = Layout::nonceOffset(nonceOffset);
+            const size_t word = offset / 8;
+            const int shift = static_cast<int>(offset % 8) * 8;
+            const int unused = static_cast<int>(8 - Layout::nonceWidth(nonceWidth)) * 8;
+            keccak_lanes_t nonces;
+            keccak_lanes_t s[25];
+            std::uint64_t scalars[Scalars][25];
+            for (size_t l = 0; l < lanes; ++l) {
+                nonces[l] = byteSwap64((nonce + l) << unused);
+            }
+            for (size_t w = 0; w < 25; ++w) {
+                std::uint64_t value = w < rate / 8 ? base[w] : 0;
+                for (size_t l = 0; l < lanes; ++l) {
+                    s[w][l] = value;
+                }
+                for (size_t k = 0; k < Scalars; ++k) {
+                    scalars[k][w] = value;
+                }
+            }
+            s[word] ^= nonces << shift;
+            if (shift != 0) {
+                s[word + 1] ^= nonces >> (64 - shift);
+            }
+            for (size_t k = 0; k < Scalars; ++k) {
+                std::uint64_t value = byteSwap64((nonce + lanes + k) << unused);
+                scalars[k][word] ^= value << shift;
+                if (shift != 0) {
+                    scalars[k][word + 1] ^= value >> (64 - shift);
+                }
+            }
+            keccakF1600xNHybrid<Scalars>(s, scalars);
+            for (size_t w = 0; w < 4; ++w) {
+                for (size_t l = 0; l < lanes; ++l) {
+                    storeLane(hashes[l] + w * 8, s[w][l]);
+                }
+                for (size_t k = 0; k < Scalars; ++k) {
+                    storeLane(hashes[lanes + k] + w * 8, scalars[k][w]);
+                }
+            }
+        }
+
+    private:
+        MultiBufferKernel<Layout> vector;
+        std::vector<std::uint8_t> data;
+        size_t nonceOffset;
+        size_t nonceWidth;
+        bool singleBlock;
+        Keccak256 keccak;
+        std::uint64_t base[rate / 8];
+};
+
+template<class Layout>
+using HybridKernel1 = HybridKernel<Layout, 1>;
+
+template<class Layout>
+using HybridKernel2 = HybridKernel<Layout, 2>;
+
+// Not a kernel itself: each range runs ScalarKernel or MultiBufferKernel as picked by the
+// worker's bandit (bandit.h).
+template<class Layout>
+class AdaptiveKernel {
+    public:
+        static constexpr const char* name = "adaptive";
+        static constexpr const char* arms[] = {ScalarKernel<Layout>::name, MultiBufferKernel<Layout>::name};
+        static constexpr std::uint64_t probeShare = 16;
+};
+
+static void pinWorker(const EngineOptions& options, int worker) {
+    if (!options.cpus.empty()) {
+        pinCurrentThread(options.cpus[worker % options.cpus.size()]);
+    }
+}
+
+static int activeWorkers(const EngineOptions& options, const EngineContext& context) {
+    return context.gate ? std::min(options.threads, context.gate->active.load()) : options.threads;
+}
+
+// Runs work(worker, begin, end), then idles per the gate's duty cycle (woken early by `found`).
+template<class Work>
+static void runRange(const EngineContext& context, Work& work, int worker, std::uint64_t begin, std::uint64_t end) {
+    auto start = std::chrono::steady_clock::now();
+    work(worker, begin, end);
+    int duty = context.gate ? context.gate->duty.load() : 100;
+    if (duty >= 100) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto resume = now + (now - start) * (100 - duty) / std::max(duty, 1);
+    while (now < resume && !context.found.load()) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(resume - now, std::chrono::milliseconds(50)));
+        now = std::chrono::steady_clock::now();
+    }
+}
+
+// Scheduler policies call work(worker, begin, end) on nonce ranges until `found` is set.
+struct SpawnPerBatch {
+    static constexpr const char* name = "batch";
+
+    template<class Work>
+    static void run(const Job& job, const EngineOptions& options, const EngineContext& context, Work&& work) {
+        std::uint64_t nonce = job.startNonce;
+        while (!context.found.load()) {
+            std::vector<std::thread> threads;
+            const int workers = activeWorkers(options, context);
+            for (int t = 0; t < workers && !context.found.load(); ++t, nonce += job.batchSize) {
+                threads.emplace_back([&, t, begin = nonce]() {
+                    pinWorker(options, t);
+                    runRange(context, work, t, begin, begin + job.batchSize);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+    }
+};
+
+struct PersistentRanges {
+    static constexpr const char* name = "persistent";
+
+    template<class Work>
+    static void run(const Job& job, const EngineOptions& options, const EngineContext& context, Work&& work) {
+        std::atomic<std::uint64_t> next(job.startNonce);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < options.threads; ++t) {
+            threads.emplace_back([&, t]() {
+                pinWorker(options, t);
+                while (!context.found.load()) {
+                    if (t >= activeWorkers(options, context)) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                        continue;
+                    }
+                    std::uint64_t begin = next.fetch_add(job.batchSize);
+                    runRange(context, work, t, begin, begin + job.batchSize);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+// Result policies see every hash of a worker's range and are merged into the outcome after it.
+struct FirstHit {
+    static constexpr const char* name = "first";
+
+    explicit FirstHit(size_t) {}
+    INLINE void observe(const std::uint8_t*, std::uint64_t) {}
+    void merge(Outcome&) const {}
+};
+
+struct KeepTopK {
+    static constexpr const char* name = "topk";
+
+    explicit KeepTopK(size_t k) : local(k) {}
+
+    INLINE void observe(const std::uint8_t* hash, std::uint64_t nonce) {
+        if (local.admits(hash)) {
+            local.push(hash, nonce);
+        }
+    }
+
+    void merge(Outcome& outcome) const { outcome.best.merge(local); }
+
+    TopK local;
+};
+
+template<template<class> class Kernel, class RangeScheduler, class ResultPolicy>
+class MiningEngine {
+    public:
+        static Outcome mine(const Job& job, const EngineOptions& options, const EngineContext& context) {
+            return dispatch(job)(job, options, context);
+        }
+
+    private:
+        using MineFn = Outcome (*)(const Job&, const EngineOptions&, const EngineContext&);
+
+        // Runtime dispatch table: message layout x difficulty tier.
+        static MineFn dispatch(const Job& job) {
+            static const MineFn table[2][5] = {
+                {
+                    &mineWith<KaleLayout, DifficultyTier<8>>, &mineWith<KaleLayout, DifficultyTier<16>>,
+                    &mineWith<KaleLayout, DifficultyTier<64>>, &mineWith<KaleLayout, AnyDifficulty>,
+                    &mineWith<KaleLayout, BelowTarget>
+                },
+                {
+                    &mineWith<DynamicLayout, DifficultyTier<8>>, &mineWith<DynamicLayout, DifficultyTier<16>>,
+                    &mineWith<DynamicLayout, DifficultyTier<64>>, &mineWith<DynamicLayout, AnyDifficulty>,
+                    &mineWith<DynamicLayout, BelowTarget>
+                }
+            };
+            int tier = job.belowTarget ? 4
+                : DifficultyTier<8>::accepts(job.difficulty) ? 0
+                : DifficultyTier<16>::accepts(job.difficulty) ? 1
+                : DifficultyTier<64>::accepts(job.difficulty) ? 2 : 3;
+            return table[KaleLayout::matches(job) ? 0 : 1][tier];
+        }
+
+        template<class Layout, class Tier>
+        static Outcome mineWith(const Job& job, const EngineOptions& options, const EngineContext& context) {
+            Outcome outcome;
+            outcome.best = TopK(options.topCount);
+            std::mutex mutex;
+            KernelBandit bandit(options.threads, 2, KECCAK == 0 ? 1 : 0);
+            RangeScheduler::run(job, options, context, [&](int worker, std::uint64_t begin, std::uint64_t end) {
+                ResultPolicy policy(options.topCount);
+                Candidate hit;
+                bool hasHit = searchRange<Layout, Tier>(job, options, context, bandit, worker, begin, end, policy, hit);
+                std::lock_guard<std::mutex> lock(mutex);
+                policy.merge(outcome);
+                if (hasHit && !outcome.found) {
+                    outcome.found = true;
+                    outcome.hash = hit.hash;
+                    outcome.nonce = hit.nonce;
+                    context.found.store(true);
+                }
+            });
+            return outcome;
+        }
+
+        template<class Layout, class Tier>
+        static bool searchRange(const Job& job, const EngineOptions& options, const EngineContext& context, KernelBandit& bandit,
+            int worker, std::uint64_t begin, std::uint64_t end, ResultPolicy& policy, Candidate& hit) {
+            if constexpr (!std::is_same_v<Kernel<Layout>, AdaptiveKernel<Layout>>) {
+                return search<Kernel<Layout>, Tier>(job, options, context, worker, begin, end, policy, hit);
+            } else {
+                // Exploration probes the other kernel on a slice of the range, so a slow arm costs
+                // little wall time; the preferred kernel hashes the rest.
+                int arm = bandit.choose(worker);
+                int fastest = bandit.preferred(worker);
+                std::uint64_t split = arm == fastest ? begin : std::min(end, begin + std::max<std::uint64_t>((end - begin) / AdaptiveKernel<Layout>::probeShare, 1));
+                bool stopped = false;
+                auto timed = [&](int kernel, std::uint64_t from, std::uint64_t to) {
+                    auto start = std::chrono::steady_clock::now();
+                    bool hasHit = kernel == 0 ? search<ScalarKernel<Layout>, Tier>(job, options, context, worker, from, to, policy, hit)
+                        : search<MultiBufferKernel<Layout>, Tier>(job, options, context, worker, from, to, policy, hit);
+                    // Slices cut short by a hit say nothing about throughput.
+                    if (hasHit || context.found.load()) {
+                        stopped = true;
+                        return hasHit;
+                    }
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    if (bandit.record(worker, kernel, static_cast<double>(to - from), elapsed.count()) && options.verbose) {
+                        int best = bandit.preferred(worker);
+                        AsyncLog::instance().write("[CPU] Worker %llu kernel %s", worker, std::string(AdaptiveKernel<Layout>::arms[best])
+                            + " (" + formatHashRate(bandit.rate(worker, best)) + " vs " + formatHashRate(bandit.rate(worker, 1 - best)) + ")");
+                    }
+                    return false;
+                };
+                bool hasHit = split > begin && timed(arm, begin, split);
+                return hasHit || (!stopped && timed(fastest, split, end));
+            }
+        }
+
+        template<class LayoutKernel, class Tier>
+        static bool search(const Job& job, const EngineOptions& options, const EngineContext& context,
+            int worker, std::uint64_t begin, std::uint64_t end, ResultPolicy& policy, Candidate& hit) {
+            if (options.verbose) {
+                AsyncLog::instance().write("[CPU] Mining batch: %llu %s", begin, job.description);
+            }
+            LayoutKernel kernel(job);
+            const Target target(job);
+            alignas(64) std::uint8_t hashes[LayoutKernel::width][32];
+            std::uint64_t counter = 0;
+            for (std::uint64_t nonce = begin; nonce < end && !context.found.load(std::memory_order_relaxed);
+                nonce += LayoutKernel::width) {
+                kernel.hash(nonce, hashes);
+                for (size_t l = 0; l < LayoutKernel::width && nonce + l < end; ++l) {
+                    policy.observe(hashes[l], nonce + l);
+                    if (Tier::meets(hashes[l], target, job.difficulty)) {
+                        std::memcpy(hit.hash.data(), hashes[l], 32);
+                        hit.nonce = nonce + l;
+                        countHashes(context, worker, counter + l + 1);
+                        return true;
+                    }
+                }
+                counter += LayoutKernel::width;
+                if (counter >= hashRateInterval) {
+                    countHashes(context, worker, counter);
+                    counter = 0;
+                }
+            }
+            countHashes(context, worker, counter);
+            return false;
+        }
+
+        static void countHashes(const EngineContext& context, int worker, std::uint64_t hashes) {
+            context.hashMetric.fetch_add(hashes, std::memory_order_relaxed);
+            if (context.workerHashes) {
+                context.workerHashes[worker].hashes.fetch_add(hashes, std::memory_order_relaxed);
+            }
+        }
+};
+
+using EngineFn = Outcome (*)(const Job&, const EngineOptions&, const EngineContext&);
+
+struct EngineEntry {
+    const char* kernel;
+    const char* scheduler;
+    const char* result;
+    EngineFn mine;
+};
+
+template<template<class> class Kernel, class RangeScheduler, class ResultPolicy>
+EngineEntry engineEntry() {
+    return {Kernel<DynamicLayout>::name, RangeScheduler::name, ResultPolicy::name, &MiningEngine<Kernel, RangeScheduler, ResultPolicy>::mine};
+}
+
+inline const std::vector<EngineEntry>& engineRegistry() {
+    static const std::vector<EngineEntry> registry = {
+        engineEntry<ScalarKernel, SpawnPerBatch, FirstHit>(),
+        engineEntry<ScalarKernel, SpawnPerBatch, KeepTopK>(),
+        engineEntry<ScalarKernel, PersistentRanges, FirstHit>(),
+        engineEntry<ScalarKernel, PersistentRanges, KeepTopK>(),
+        engineEntry<MultiBufferKernel, SpawnPerBatch, FirstHit>(),
+        engineEntry<MultiBufferKernel, SpawnPerBatch, KeepTopK>(),
+        engineEntry<MultiBufferKernel, PersistentRanges, FirstHit>(),
+        engineEntry<MultiBufferKernel, PersistentRanges, KeepTopK>(),
+        engineEntry<HybridKernel1, SpawnPerBatch, FirstHit>(),
+        engineEntry<HybridKernel1, SpawnPerBatch, KeepTopK>(),
+        engineEntry<HybridKernel1, PersistentRanges, FirstHit>(),
+        engineEntry<HybridKernel1, PersistentRanges, KeepTopK>(),
+        engineEntry<HybridKernel2, SpawnPerBatch, FirstHit>(),
+        engineEntry<HybridKernel2, SpawnPerBatch, KeepTopK>(),
+        engineEntry<HybridKernel2, PersistentRanges, FirstHit>(),
+        engineEntry<HybridKernel2, PersistentRanges, KeepTopK>(),
+        engineEntry<AdaptiveKernel, SpawnPerBatch, FirstHit>(),
+        engineEntry<AdaptiveKernel, SpawnPerBatch, KeepTopK>(),
+        engineEntry<AdaptiveKernel, PersistentRanges, FirstHit>(),
+        engineEntry<AdaptiveKernel, PersistentRanges, KeepTopK>()
+    };
+    return registry;
+}
+
+inline const EngineEntry* findEngine(const std::string& kernel, const std::string& scheduler, const std::string& result) {
+    for (const auto& entry : engineRegistry()) {
+        if (kernel == entry.kernel && scheduler == entry.scheduler && result == entry.result) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
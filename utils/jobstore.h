@@ -0,0 +1,202 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Job store for daemon mode (--daemon), sized for thousands of concurrent farmers. Jobs live in
+    fixed slots of one arena allocated up front, as parallel arrays (absorbed KALE block, nonce
+    cursor, difficulty, generation), with a dense list of active slots. Insert, cancel and
+    complete are O(1): a free-slot stack, swap-remove from the active list and an id index.
+    Workers hash micro-slices round-robin across the active jobs; switching only copies the 17
+    absorbed words into the multi-buffer kernel, with no allocation.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "engine.h"
+
+// One micro-slice of a job, copied out of the store so it is hashed without holding the lock.
+struct JobSlice {
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+    int difficulty = 0;
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+    std::uint64_t words[blockWords];
+};
+
+class JobStore {
+    public:
+        explicit JobStore(size_t capacity)
+            : words(capacity * blockWords), startNonce(capacity), cursor(new std::atomic<std::uint64_t>[capacity]),
+              difficulty(capacity), generation(capacity), position(capacity, none), ids(capacity) {
+            active.reserve(capacity);
+            freeSlots.reserve(capacity);
+            for (size_t slot = capacity; slot > 0; --slot) {
+                freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
+            }
+            index.reserve(capacity);
+        }
+
+        size_t capacity() const { return ids.size(); }
+
+        size_t size() const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return active.size();
+        }
+
+        // Only KALE-layout jobs (one Keccak block, 8-byte nonce) of 1 to 64 nibbles.
+        void insert(const std::string& id, const Job& job) {
+            if (!KaleLayout::matches(job) || job.belowTarget || job.difficulty < 1 || job.difficulty > 64) {
+                throw std::invalid_argument("Daemon jobs must use the KALE layout and a difficulty of 1 to 64.");
+            }
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            if (freeSlots.empty()) {
+                throw std::invalid_argument("Job store full.");
+            }
+            if (!index.emplace(id, freeSlots.back()).second) {
+                throw std::invalid_argument("Duplicate job id.");
+            }
+            std::uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            absorbBlock(job, &words[slot * blockWords]);
+            startNonce[slot] = job.startNonce;
+            cursor[slot].store(job.startNonce, std::memory_order_relaxed);
+            difficulty[slot] = static_cast<std::uint8_t>(job.difficulty);
+            ids[slot] = id;
+            position[slot] = static_cast<std::uint32_t>(active.size());
+            active.push_back(slot);
+        }
+
+        bool cancel(const std::string& id) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto found = index.find(id);
+            if (found == index.end()) {
+                return false;
+            }
+            remove(found->second);
+            return true;
+        }
+
+        // The next job in round-robin order and its next `sliceSize` nonces; false when idle.
+        bool next(JobSlice& slice, std::uint64_t sliceSize) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            if (active.empty()) {
+                return false;
+            }
+            std::uint32_t slot = active[turn.fetch_add(1, std::memory_order_relaxed) % active.size()];
+            slice.slot = slot;
+            slice.generation = generation[slot];
+            slice.difficulty = difficulty[slot];
+            slice.begin = cursor[slot].fetch_add(sliceSize, std::memory_order_relaxed);
+            slice.end = slice.begin + sliceSize;
+            std::copy(&words[slot * blockWords], &words[(slot + 1) * blockWords], slice.words);
+            return true;
+        }
+
+        // Completes the slice's job on a hit. False when it was cancelled or completed meanwhile;
+        // otherwise `id` and `hashes` (nonces handed out for it) describe the job.
+        bool complete(const JobSlice& slice, std::string& id, std::uint64_t& hashes) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            if (generation[slice.slot] != slice.generation || position[slice.slot] == none) {
+                return false;
+            }
+            id = ids[slice.slot];
+            hashes = cursor[slice.slot].load(std::memory_order_relaxed) - startNonce[slice.slot];
+            remove(slice.slot);
+            return true;
+        }
+
+    private:
+        static constexpr std::uint32_t none = ~0u;
+
+        mutable std::shared_mutex mutex;
+        std::vector<std::uint64_t> words;
+        std::vector<std::uint64_t> startNonce;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> cursor;
+        std::vector<std::uint8_t> difficulty;
+        std::vector<std::uint32_t> generation;
+        std::vector<std::uint32_t> position;    // Index in `active`, `none` when free.
+        std::vector<std::string> ids;
+        std::vector<std::uint32_t> active;
+        std::vector<std::uint32_t> freeSlots;
+        std::unordered_map<std::string, std::uint32_t> index;
+        std::atomic<std::uint64_t> turn{0};
+
+        void remove(std::uint32_t slot) {
+            std::uint32_t moved = active.back();
+            active[position[slot]] = moved;
+            position[moved] = position[slot];
+            active.pop_back();
+            position[slot] = none;
+            ++generation[slot];
+            index.erase(ids[slot]);
+            freeSlots.push_back(slot);
+        }
+};
+
+// Hashed nonces and job switches with the time spent switching (picking the next slice and
+// loading its block), per worker.
+struct alignas(64) SliceStats {
+    std::atomic<std::uint64_t> hashes{0};
+    std::atomic<std::uint64_t> switches{0};
+    std::atomic<std::uint64_t> switchNanos{0};
+};
+
+// Worker loop: hashes micro-slices of the store's jobs until `stop`, calling onHit(slice, hash,
+// nonce) for each one that meets its job's difficulty. Idles while the store is empty.
+template<class OnHit>
+void runJobSlices(JobStore& store, std::uint64_t sliceSize, const std::atomic<bool>& stop, SliceStats& stats, OnHit&& onHit) {
+    using Kernel = MultiBufferKernel<KaleLayout>;
+    sliceSize = std::max<std::uint64_t>(sliceSize / Kernel::width, 1) * Kernel::width;
+    Job layout;
+    layout.data.resize(76);
+    layout.nonceOffset = 4;
+    Kernel kernel(layout);
+    alignas(64) std::uint8_t hashes[Kernel::width][32];
+    JobSlice slice;
+    while (!stop.load(std::memory_order_relaxed)) {
+        auto start = std::chrono::steady_clock::now();
+        if (!store.next(slice, sliceSize)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        kernel.load(slice.words);
+        const Target target(slice.difficulty);
+        auto loaded = std::chrono::steady_clock::now();
+        stats.switches.fetch_add(1, std::memory_order_relaxed);
+        stats.switchNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(loaded - start).count(), std::memory_order_relaxed);
+        std::uint64_t nonce = slice.begin;
+        for (; nonce < slice.end; nonce += Kernel::width) {
+            kernel.hash(nonce, hashes);
+            bool hit = false;
+            for (size_t l = 0; l < Kernel::width; ++l) {
+                if (DifficultyTier<64>::meets(hashes[l], target, slice.difficulty)) {
+                    onHit(slice, hashes[l], nonce + l);
+                    hit = true;
+                    break;
+                }
+            }
+            if (hit) {
+                nonce += Kernel::width;
+                break;
+            }
+        }
+        stats.hashes.fetch_add(nonce - slice.begin, std::memory_order_relaxed);
+    }
+}
@@ -64,14 +64,15 @@ INLINE void* assume_aligned(void* p, size_t align) {
 #include "keccak_ref.h"
 class Keccak256 {
     public:
-        Keccak256() { reset(); }
+        // 0x01 is Keccak-256 padding, 0x06 gives SHA3-256.
+        explicit Keccak256(uint8_t padding = 0x01) : padding(padding) { reset(); }
 
         void update(const uint8_t* data, size_t len) {
             buffer.insert(buffer.end(), data, data + len);
         }
 
         void finalize(uint8_t* hash) {
-            Keccak(1088, 512, buffer.data(), buffer.size(), 0x01, hash, 32);
+            Keccak(1088, 512, buffer.data(), buffer.size(), padding, hash, 32);
             reset();
         }
 
@@ -79,15 +80,24 @@ class Keccak256 {
             buffer.clear();
         }
     private:
+        uint8_t padding;
         std::vector<uint8_t> buffer;
 };
 #else
 class Keccak256 {
     public:
-        Keccak256() { reset(); }
+        // 0x01 is Keccak-256 padding, 0x06 gives SHA3-256.
+        explicit Keccak256(uint8_t padding = 0x01) : padding(padding) { reset(); }
 
         void update(const uint8_t* data, size_t len) {
             while (len > 0) {
+                if (offset == 0 && len >= rate) {
+                    absorbBlock(state, data);
+                    keccakF1600(state);
+                    data += rate;
+                    len -= rate;
+                    continue;
+                }
                 size_t chunk = (len < rate - offset) ? len : rate - offset;
                 for (size_t i = 0; i < chunk; ++i)
                     state[offset + i] ^= data[i];
@@ -102,7 +112,7 @@ class Keccak256 {
         }
     
         void finalize(uint8_t* hash) {
-            state[offset] ^= 0x01;
+            state[offset] ^= padding;
             state[rate - 1] ^= 0x80;
             keccakF1600(state);
             std::memcpy(hash, state, 32);
@@ -118,6 +128,7 @@ class Keccak256 {
         static constexpr size_t stateSize = (rate + capacity) / 8;
         alignas(64) uint8_t state[200] = {};
         size_t offset = 0;
+        uint8_t padding;
 
         static void keccakF1600(uint8_t* RESTRICT state) {
             #if KECCAK == KECCAK_OPT
@@ -192,6 +203,17 @@ class Keccak256 {
             #endif
         }
 
+        // Whole blocks are XORed into the state one 64-bit lane at a time.
+        static INLINE void absorbBlock(uint8_t* RESTRICT state, const uint8_t* RESTRICT data) {
+            uint64_t* RESTRICT state64 = reinterpret_cast<uint64_t*>(ASSUME_ALIGNED(state, 64));
+            PRAGMA_UNROLL(17)
+            for (size_t i = 0; i < rate / 8; ++i) {
+                uint64_t lane;
+                std::memcpy(&lane, data + i * 8, sizeof(lane));
+                state64[i] ^= lane;
+            }
+        }
+
         static INLINE uint64_t rotl64(uint64_t x, uint64_t n) {
             return (x << n) | (x >> (64 - n));
         }
@@ -241,4 +263,6 @@ class Keccak256 {
         }
         #endif
     };
-#endif
\ No newline at end of file
+#endif
+
+#include "keccak_simd.h"
@@ -0,0 +1,217 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Multi-buffer Keccak-f[1600] permutation: KECCAK_LANES independent states interleaved
+    lane-wise so that each 64-bit state word of every message sits in one vector register.
+    Uses GCC/Clang generic vectors (AVX2/AVX-512 on x86, NEON on ARM, SIMD128 on wasm).
+    Portable; falls back to plain arrays on other compilers. Included from keccak.h.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#ifndef KECCAK_LANES
+#if defined(__AVX512F__)
+#define KECCAK_LANES 8
+#elif defined(__aarch64__) || defined(__wasm_simd128__)
+#define KECCAK_LANES 2
+#else
+#define KECCAK_LANES 4
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+typedef uint64_t keccak_lanes_t __attribute__((vector_size(KECCAK_LANES * sizeof(uint64_t))));
+#else
+struct keccak_lanes_t {
+    uint64_t v[KECCAK_LANES];
+    INLINE uint64_t& operator[](size_t i) { return v[i]; }
+    INLINE uint64_t operator[](size_t i) const { return v[i]; }
+    #define KECCAK_LANES_OP(op)                                                         \
+        INLINE keccak_lanes_t operator op(const keccak_lanes_t& o) const {              \
+            keccak_lanes_t r; for (size_t i = 0; i < KECCAK_LANES; ++i) r.v[i] = v[i] op o.v[i]; return r; } \
+        INLINE keccak_lanes_t operator op(uint64_t o) const {                           \
+            keccak_lanes_t r; for (size_t i = 0; i < KECCAK_LANES; ++i) r.v[i] = v[i] op o; return r; } \
+        INLINE keccak_lanes_t& operator op##=(const keccak_lanes_t& o) { return *this = *this op o; } \
+        INLINE keccak_lanes_t& operator op##=(uint64_t o) { return *this = *this op o; }
+    KECCAK_LANES_OP(^)
+    KECCAK_LANES_OP(&)
+    KECCAK_LANES_OP(<<)
+    KECCAK_LANES_OP(>>)
+    #undef KECCAK_LANES_OP
+    INLINE keccak_lanes_t operator~() const {
+        keccak_lanes_t r; for (size_t i = 0; i < KECCAK_LANES; ++i) r.v[i] = ~v[i]; return r; }
+};
+#endif
+
+static INLINE keccak_lanes_t rotlLanes(keccak_lanes_t x, int n) {
+    return (x << n) ^ (x >> (64 - n));
+}
+
+static INLINE uint64_t loadLane(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static INLINE void storeLane(uint8_t* p, uint64_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+static INLINE uint64_t rotlLanes(uint64_t x, int n) {
+    return (x << n) ^ (x >> (64 - n));
+}
+
+static constexpr uint64_t keccakRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// One round on 25 state words: keccak_lanes_t for the interleaved states, uint64_t for one state.
+template<class Word>
+static INLINE void keccakRound(Word* RESTRICT s, int round) {
+    const Word c0 = s[0] ^ s[5] ^ s[10] ^ s[15] ^ s[20];
+    const Word c1 = s[1] ^ s[6] ^ s[11] ^ s[16] ^ s[21];
+    const Word c2 = s[2] ^ s[7] ^ s[12] ^ s[17] ^ s[22];
+    const Word c3 = s[3] ^ s[8] ^ s[13] ^ s[18] ^ s[23];
+    const Word c4 = s[4] ^ s[9] ^ s[14] ^ s[19] ^ s[24];
+    const Word d0 = c4 ^ rotlLanes(c1, 1);
+    const Word d1 = c0 ^ rotlLanes(c2, 1);
+    const Word d2 = c1 ^ rotlLanes(c3, 1);
+    const Word d3 = c2 ^ rotlLanes(c4, 1);
+    const Word d4 = c3 ^ rotlLanes(c0, 1);
+    s[0] ^= d0; s[1] ^= d1; s[2] ^= d2; s[3] ^= d3; s[4] ^= d4;
+    s[5] ^= d0; s[6] ^= d1; s[7] ^= d2; s[8] ^= d3; s[9] ^= d4;
+    s[10] ^= d0; s[11] ^= d1; s[12] ^= d2; s[13] ^= d3; s[14] ^= d4;
+    s[15] ^= d0; s[16] ^= d1; s[17] ^= d2; s[18] ^= d3; s[19] ^= d4;
+    s[20] ^= d0; s[21] ^= d1; s[22] ^= d2; s[23] ^= d3; s[24] ^= d4;
+    Word temp = s[1];
+    #define PI_STEP_N(pi, ro) do { \
+        const Word t = s[pi]; \
+        s[pi] = rotlLanes(temp, ro); \
+        temp = t; \
+    } while(0)
+    PI_STEP_N(10, 1); PI_STEP_N(7, 3); PI_STEP_N(11, 6); PI_STEP_N(17, 10);
+    PI_STEP_N(18, 15); PI_STEP_N(3, 21); PI_STEP_N(5, 28); PI_STEP_N(16, 36);
+    PI_STEP_N(8, 45); PI_STEP_N(21, 55); PI_STEP_N(24, 2); PI_STEP_N(4, 14);
+    PI_STEP_N(15, 27); PI_STEP_N(23, 41); PI_STEP_N(19, 56); PI_STEP_N(13, 8);
+    PI_STEP_N(12, 25); PI_STEP_N(2, 43); PI_STEP_N(20, 62); PI_STEP_N(14, 18);
+    PI_STEP_N(22, 39); PI_STEP_N(9, 61); PI_STEP_N(6, 20); PI_STEP_N(1, 44);
+    #undef PI_STEP_N
+    for (int y = 0; y < 25; y += 5) {
+        const Word x0 = s[y], x1 = s[y + 1], x2 = s[y + 2], x3 = s[y + 3], x4 = s[y + 4];
+        s[y] = x0 ^ (~x1 & x2);
+        s[y + 1] = x1 ^ (~x2 & x3);
+        s[y + 2] = x2 ^ (~x3 & x4);
+        s[y + 3] = x3 ^ (~x4 & x0);
+        s[y + 4] = x4 ^ (~x0 & x1);
+    }
+    s[0] ^= keccakRoundConstants[round];
+}
+
+static INLINE void keccakF1600xN(keccak_lanes_t* RESTRICT s) {
+    for (int round = 0; round < 24; round++) {
+        keccakRound(s, round);
+    }
+}
+
+// Hybrid permutation: the vector states and `Scalars` scalar states advance in the same round
+// loop, so the SIMD units and the integer ALUs work on independent instruction streams.
+template<size_t Scalars>
+static INLINE void keccakF1600xNHybrid(keccak_lanes_t* RESTRICT s, uint64_t (*RESTRICT scalars)[25]) {
+    for (int round = 0; round < 24; round++) {
+        keccakRound(s, round);
+        for (size_t k = 0; k < Scalars; ++k) {
+            keccakRound(scalars[k], round);
+        }
+    }
+}
+
+// Hashes KECCAK_LANES messages that span the same number of full blocks (lengths / 136 equal),
+// Keccak-256 with 0x01 padding by default; each lane is padded at its own length.
+static inline void keccak256xN(const uint8_t* const* inputs, const size_t* lengths, uint8_t* const* outputs, uint8_t pad = 0x01) {
+    constexpr size_t rate = 136;
+    keccak_lanes_t s[25];
+    std::memset(s, 0, sizeof(s));
+    const size_t full = lengths[0] - lengths[0] % rate;
+    size_t offset = 0;
+    for (; offset < full; offset += rate) {
+        for (size_t w = 0; w < rate / 8; ++w)
+            for (size_t l = 0; l < KECCAK_LANES; ++l)
+                s[w][l] ^= loadLane(inputs[l] + offset + w * 8);
+        keccakF1600xN(s);
+    }
+    alignas(64) uint8_t block[rate];
+    for (size_t l = 0; l < KECCAK_LANES; ++l) {
+        const size_t remaining = lengths[l] - offset;
+        std::memset(block, 0, rate);
+        std::memcpy(block, inputs[l] + offset, remaining);
+        block[remaining] ^= pad;
+        block[rate - 1] ^= 0x80;
+        for (size_t w = 0; w < rate / 8; ++w)
+            s[w][l] ^= loadLane(block + w * 8);
+    }
+    keccakF1600xN(s);
+    for (size_t l = 0; l < KECCAK_LANES; ++l)
+        for (size_t w = 0; w < 4; ++w)
+            storeLane(outputs[l] + w * 8, s[w][l]);
+}
+
+// Hashes KECCAK_LANES messages of identical length in one pass.
+static inline void keccak256xN(const uint8_t* const* inputs, size_t len, uint8_t* const* outputs, uint8_t pad = 0x01) {
+    size_t lengths[KECCAK_LANES];
+    for (size_t l = 0; l < KECCAK_LANES; ++l)
+        lengths[l] = len;
+    keccak256xN(inputs, lengths, outputs, pad);
+}
+
+// Keccak-256 of n independent messages of any length. Messages are grouped by block count and
+// hashed KECCAK_LANES at a time; groups that do not fill the lanes go through Keccak256.
+static inline void keccak256_many(const uint8_t* const* inputs, const size_t* lengths, uint8_t* const* outputs, size_t n) {
+    constexpr size_t rate = 136;
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return lengths[a] / rate < lengths[b] / rate;
+    });
+    const uint8_t* laneInputs[KECCAK_LANES];
+    size_t laneLengths[KECCAK_LANES];
+    uint8_t* laneOutputs[KECCAK_LANES];
+    Keccak256 keccak;
+    for (size_t begin = 0; begin < n;) {
+        const size_t blocks = lengths[order[begin]] / rate;
+        size_t end = begin;
+        while (end < n && lengths[order[end]] / rate == blocks)
+            ++end;
+        for (; end - begin >= KECCAK_LANES; begin += KECCAK_LANES) {
+            for (size_t l = 0; l < KECCAK_LANES; ++l) {
+                laneInputs[l] = inputs[order[begin + l]];
+                laneLengths[l] = lengths[order[begin + l]];
+                laneOutputs[l] = outputs[order[begin + l]];
+            }
+            keccak256xN(laneInputs, laneLengths, laneOutputs);
+        }
+        for (; begin < end; ++begin) {
+            keccak.reset();
+            keccak.update(inputs[order[begin]], lengths[order[begin]]);
+            keccak.finalize(outputs[order[begin]]);
+        }
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,180 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Asynchronous logging for hot threads. Each thread pushes fixed-size records into its own
+    single-producer/single-consumer ring (no lock, no allocation, no syscall); one background
+    thread drains every ring, formats the records and writes them with a single write per pass.
+    A full ring drops the record rather than stall the worker; drops are reported.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct LogRecord {
+    // printf format taking (unsigned long long value, const char* text), or nullptr for text only.
+    const char* format;
+    unsigned long long value;
+    char text[200];
+};
+
+template<size_t Capacity>
+class SpscRing {
+    public:
+        bool push(const LogRecord& record) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+            slots[head % Capacity] = record;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop(LogRecord& record) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            record = slots[tail % Capacity];
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+
+        // Producer ownership, so rings of exited threads are reused by new ones.
+        std::atomic<bool> owned{false};
+
+    private:
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+        std::array<LogRecord, Capacity> slots;
+};
+
+class AsyncLog {
+    public:
+        static constexpr size_t ringCapacity = 256;
+        static constexpr size_t maxRings = 128;
+
+        // Never destroyed: the writer thread is detached and may outlive main().
+        static AsyncLog& instance() {
+            static AsyncLog* log = new AsyncLog();
+            return *log;
+        }
+
+        void write(const char* format, unsigned long long value, const std::string& text) {
+            LogRecord record;
+            record.format = format;
+            record.value = value;
+            size_t size = std::min(text.size(), sizeof(record.text) - 1);
+            std::memcpy(record.text, text.data(), size);
+            record.text[size] = '\0';
+            Ring* ring = threadRing();
+            if (!ring || !ring->push(record)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void write(const std::string& line) { write(nullptr, 0, line); }
+
+        // Blocks until every record pushed so far has been written (call before other output).
+        void flush() {
+            std::lock_guard<std::mutex> lock(drainMutex);
+            drain();
+        }
+
+    private:
+        using Ring = SpscRing<ringCapacity>;
+
+        std::array<Ring, maxRings> rings;
+        std::atomic<size_t> ringCount{0};
+        std::atomic<size_t> nextRing{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::mutex drainMutex;
+
+        AsyncLog() {
+            std::thread([this]() {
+                while (true) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    std::lock_guard<std::mutex> lock(drainMutex);
+                    drain();
+                }
+            }).detach();
+        }
+
+        struct RingHandle {
+            Ring* ring = nullptr;
+            ~RingHandle() {
+                if (ring) {
+                    ring->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        Ring* threadRing() {
+            thread_local RingHandle handle;
+            for (size_t i = 0; !handle.ring && i < ringCount.load(std::memory_order_acquire); ++i) {
+                claim(i, handle);
+            }
+            while (!handle.ring) {
+                size_t index = nextRing.fetch_add(1, std::memory_order_relaxed);
+                if (index >= maxRings) {
+                    return nullptr;
+                }
+                if (claim(index, handle)) {
+                    size_t count = ringCount.load(std::memory_order_relaxed);
+                    while (count < index + 1 && !ringCount.compare_exchange_weak(count, index + 1, std::memory_order_release)) {
+                    }
+                }
+            }
+            return handle.ring;
+        }
+
+        bool claim(size_t index, RingHandle& handle) {
+            bool expected = false;
+            if (rings[index].owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                handle.ring = &rings[index];
+                return true;
+            }
+            return false;
+        }
+
+        void drain() {
+            std::string buffer;
+            char line[512];
+            LogRecord record;
+            size_t count = ringCount.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                while (rings[i].pop(record)) {
+                    if (record.format) {
+                        std::snprintf(line, sizeof(line), record.format, record.value, record.text);
+                        buffer += line;
+                    } else {
+                        buffer += record.text;
+                    }
+                    buffer += '\n';
+                }
+            }
+            std::uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                buffer += "[LOG] " + std::to_string(lost) + " records dropped\n";
+            }
+            if (!buffer.empty()) {
+                std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+                std::fflush(stdout);
+            }
+        }
+};
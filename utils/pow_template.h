@@ -0,0 +1,171 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Declarative proof-of-work templates for Keccak/SHA3-based Soroban contracts. A template lists
+    the message fields in order, the nonce position and width, the hash variant and the target
+    predicate, and compiles to an engine Job. KALE compiles to the 76-byte KaleLayout fast path.
+
+    Spec: <field>,<field>,...[;hash=keccak256|sha3-256][;target=zeros|below:<hex>]
+      i32:<v> u32:<v> i64:<v> u64:<v>    big-endian integers
+      hex:<hex> base64:<b64>             raw bytes
+      address:<G...> key:<G...>          account ScAddress XDR, or its last 32 bytes (ed25519 key)
+      string:<text> hash:<b64>           ScVal string / 32-byte hash XDR
+      nonce:<4|8>                        big-endian nonce of 4 or 8 bytes (exactly one)
+    Values may be {block}, {hash} or {miner} to take the positional command line arguments.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "misc.h"
+#include "engine.h"
+
+class PowTemplate {
+    public:
+        struct Field {
+            std::string kind;
+            std::string value;
+        };
+
+        std::vector<Field> fields;
+        std::uint8_t pad = 0x01;
+        bool belowTarget = false;
+        std::array<std::uint8_t, 32> threshold{};
+
+        static const char* kale() {
+            return "i32:{block},nonce:8,base64:{hash},key:{miner};hash=keccak256;target=zeros";
+        }
+
+        static PowTemplate parse(const std::string& spec) {
+            PowTemplate pow;
+            std::vector<std::string> sections = split(spec, ';');
+            int nonces = 0;
+            for (const std::string& item : split(sections[0], ',')) {
+                size_t colon = item.find(':');
+                if (colon == std::string::npos) {
+                    throw std::invalid_argument("Template field '" + item + "' is not <kind>:<value>.");
+                }
+                Field field{item.substr(0, colon), item.substr(colon + 1)};
+                static const char* kinds[] = {"i32", "u32", "i64", "u64", "hex", "base64", "address", "key", "string", "hash", "nonce"};
+                if (std::find(std::begin(kinds), std::end(kinds), field.kind) == std::end(kinds)) {
+                    throw std::invalid_argument("Unknown template field kind '" + field.kind + "'.");
+                }
+                if (field.kind == "nonce") {
+                    if (field.value != "4" && field.value != "8") {
+                        throw std::invalid_argument("Nonce width must be 4 or 8 bytes.");
+                    }
+                    ++nonces;
+                }
+                pow.fields.push_back(field);
+            }
+            if (nonces != 1) {
+                throw std::invalid_argument("Template needs exactly one nonce field.");
+            }
+            for (size_t i = 1; i < sections.size(); ++i) {
+                const std::string& option = sections[i];
+                if (option == "hash=keccak256") {
+                    pow.pad = 0x01;
+                } else if (option == "hash=sha3-256") {
+                    pow.pad = 0x06;
+                } else if (option == "target=zeros") {
+                    pow.belowTarget = false;
+                } else if (option.rfind("target=below:", 0) == 0) {
+                    std::vector<std::uint8_t> bytes = hexDecode(option.substr(13));
+                    if (bytes.size() != 32) {
+                        throw std::invalid_argument("Target must be 32 bytes of hex.");
+                    }
+                    pow.belowTarget = true;
+                    std::copy(bytes.begin(), bytes.end(), pow.threshold.begin());
+                } else {
+                    throw std::invalid_argument("Unknown template option '" + option + "'.");
+                }
+            }
+            return pow;
+        }
+
+        // Builds the message for `nonce` and fills the job's layout, hash variant and target.
+        void compile(const std::map<std::string, std::string>& arguments, std::uint64_t nonce, Job& job) const {
+            job.data.clear();
+            for (const Field& field : fields) {
+                std::string value = field.value;
+                if (value.size() > 2 && value.front() == '{' && value.back() == '}') {
+                    auto it = arguments.find(value.substr(1, value.size() - 2));
+                    if (it == arguments.end()) {
+                        throw std::invalid_argument("Unknown template argument " + value + ".");
+                    }
+                    value = it->second;
+                }
+                if (field.kind == "nonce") {
+                    job.nonceOffset = job.data.size();
+                    job.nonceWidth = std::stoi(value);
+                    auto bytes = i64ToBytes(nonce);
+                    job.data.insert(job.data.end(), bytes.end() - job.nonceWidth, bytes.end());
+                } else if (field.kind == "i32" || field.kind == "u32") {
+                    append(job.data, i32ToBytes(static_cast<std::uint32_t>(std::stoll(value))));
+                } else if (field.kind == "i64") {
+                    append(job.data, i64ToBytes(static_cast<std::uint64_t>(std::stoll(value))));
+                } else if (field.kind == "u64") {
+                    append(job.data, i64ToBytes(std::stoull(value)));
+                } else if (field.kind == "hex") {
+                    append(job.data, hexDecode(value));
+                } else if (field.kind == "base64") {
+                    append(job.data, base64Decode(value));
+                } else if (field.kind == "address") {
+                    append(job.data, addressToXdr(value));
+                } else if (field.kind == "key") {
+                    std::vector<std::uint8_t> xdr = addressToXdr(value);
+                    job.data.insert(job.data.end(), xdr.end() - 32, xdr.end());
+                } else if (field.kind == "string") {
+                    append(job.data, stringToXdr(value));
+                } else if (field.kind == "hash") {
+                    append(job.data, hashToXdr(value));
+                }
+            }
+            job.pad = pad;
+            job.belowTarget = belowTarget;
+            job.threshold = threshold;
+        }
+
+    private:
+        template<class Bytes>
+        static void append(std::vector<std::uint8_t>& data, const Bytes& bytes) {
+            data.insert(data.end(), bytes.begin(), bytes.end());
+        }
+
+        static std::vector<std::string> split(const std::string& text, char separator) {
+            std::vector<std::string> parts;
+            std::stringstream stream(text);
+            std::string part;
+            while (std::getline(stream, part, separator)) {
+                parts.push_back(part);
+            }
+            if (parts.empty()) {
+                parts.emplace_back();
+            }
+            return parts;
+        }
+
+        static std::vector<std::uint8_t> hexDecode(const std::string& hex) {
+            if (hex.size() % 2 != 0) {
+                throw std::invalid_argument("Odd-length hex value.");
+            }
+            std::vector<std::uint8_t> bytes(hex.size() / 2);
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                bytes[i] = static_cast<std::uint8_t>(std::stoul(hex.substr(i * 2, 2), nullptr, 16));
+            }
+            return bytes;
+        }
+};
@@ -0,0 +1,89 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Pressure-stall-aware worker gating (Linux PSI). Once per interval the governor turns the
+    "some" stall time of /proc/pressure/cpu (and optionally memory) into a percentage and moves
+    the engine's active worker count: multiplicative decrease above the target, one more worker
+    when pressure is below half of it.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "engine.h"
+
+// Cumulative "some" stall time in microseconds, -1 when PSI is unavailable.
+inline long long pressureTotal(const std::string& resource) {
+    std::ifstream file("/proc/pressure/" + resource);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t total = line.find("total=");
+        if (line.rfind("some", 0) == 0 && total != std::string::npos) {
+            return std::stoll(line.substr(total + 6));
+        }
+    }
+    return -1;
+}
+
+class PressureGovernor : public Governor {
+    public:
+        PressureGovernor(std::shared_ptr<WorkerGate> gate, int maxWorkers, double target, bool memory)
+            : gate(std::move(gate)), maxWorkers(maxWorkers), target(target), memory(memory),
+              lastCpu(pressureTotal("cpu")), lastMemory(memory ? pressureTotal("memory") : -1),
+              lastTime(std::chrono::steady_clock::now()) {}
+
+        bool available() const { return lastCpu >= 0; }
+
+        // Samples pressure since the previous call and adjusts the gate. Returns a telemetry line.
+        std::string step() override {
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double, std::micro>(now - lastTime).count();
+            lastTime = now;
+            double pressure = sample("cpu", lastCpu, elapsed);
+            if (memory) {
+                pressure = std::max(pressure, sample("memory", lastMemory, elapsed));
+            }
+            int active = gate->limit(WorkerGate::pressureLimit);
+            const char* decision = "hold";
+            if (pressure > target && active > 1) {
+                active = std::max(1, active - std::max(1, active / 4));
+                decision = "shrink";
+            } else if (pressure < target / 2 && active < maxWorkers) {
+                ++active;
+                decision = "grow";
+            }
+            gate->setLimit(WorkerGate::pressureLimit, active);
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "workers " << gate->active.load() << "/" << maxWorkers
+                 << " pressure " << pressure << "% (target " << target << "%) " << decision;
+            return line.str();
+        }
+
+    private:
+        std::shared_ptr<WorkerGate> gate;
+        int maxWorkers;
+        double target;
+        bool memory;
+        long long lastCpu;
+        long long lastMemory;
+        std::chrono::steady_clock::time_point lastTime;
+
+        static double sample(const std::string& resource, long long& last, double elapsed) {
+            long long total = pressureTotal(resource);
+            double pressure = (last >= 0 && total >= last && elapsed > 0) ? (total - last) / elapsed * 100 : 0;
+            last = total;
+            return pressure;
+        }
+};
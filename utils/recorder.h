@@ -0,0 +1,428 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    On-disk time series of engine statistics (--record <file>). The hash rate monitor appends one
+    record per second (total and per-worker rates, active workers, duty cycle, hottest thermal
+    zone, mean core frequency) and event records for job start, end and hits. A record is a
+    40-byte fixed part followed by one float per worker, so a day at 24 workers is about 11 MB. When the file reaches its size limit it is renamed to <file>.1,
+    replacing the previous one: two files at most. --report <file> reads both, prints a summary
+    and exports CSV. Records are native little-endian structs.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "thermal.h"
+
+enum StatEvent : std::uint16_t {
+    statSample = 1,     // Per-second sample; the other records carry events only.
+    statJobStart = 2,
+    statJobEnd = 4,
+    statHit = 8,
+    statGpu = 16
+};
+
+// Fixed part of a record as stored on disk; `workers` floats (per-worker H/s) follow it.
+struct StatRecordHead {
+    std::int64_t time;          // Unix milliseconds.
+    float hashRate;             // H/s.
+    float temperature;          // Celsius, 0 without thermal zones.
+    float frequency;            // GHz, 0 without cpufreq.
+    std::uint32_t block;
+    std::uint32_t active;
+    std::uint32_t workers;      // Per-worker rates that follow (CPU samples only).
+    std::uint16_t events;
+    std::uint8_t duty;
+    std::uint8_t zeros;         // Leading zeros of the hit.
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(StatRecordHead) == 40, "StatRecordHead is a fixed on-disk format");
+
+struct StatRecord : StatRecordHead {
+    std::vector<float> workerRates;
+};
+
+struct StatFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+static const char statMagic[8] = {'K', 'A', 'L', 'E', 'S', 'T', 'A', 'T'};
+static const std::uint32_t statVersion = 2;
+
+inline bool validStatHeader(const StatFileHeader& header) {
+    return std::memcmp(header.magic, statMagic, sizeof(statMagic)) == 0 && header.version == statVersion
+        && header.recordSize == sizeof(StatRecordHead);
+}
+
+// Reads the next record; false at the end of the file or on a torn record.
+inline bool readStatRecord(std::FILE* file, StatRecord& record) {
+    if (std::fread(static_cast<StatRecordHead*>(&record), sizeof(StatRecordHead), 1, file) != 1 || record.workers > (1u << 16)) {
+        return false;
+    }
+    record.workerRates.resize(record.workers);
+    return std::fread(record.workerRates.data(), sizeof(float), record.workers, file) == record.workers;
+}
+
+class StatRecorder {
+    public:
+        static constexpr std::uint64_t defaultMaxBytes = 16ULL << 20;
+
+        // `workers` is 0 for GPU runs. `gate` (may be null) reports active workers and duty.
+        StatRecorder(const std::string& path, std::uint64_t maxBytes, std::uint32_t block, int workers, std::shared_ptr<WorkerGate> gate)
+            : path(path), maxBytes(std::max<std::uint64_t>(maxBytes, sizeof(StatFileHeader) + sizeof(StatRecordHead) + workers * sizeof(float))), block(block),
+              workers(workers), gate(std::move(gate)), counters(new WorkerCounter[std::max(workers, 1)]),
+              last(std::max(workers, 1), 0) {}
+
+        ~StatRecorder() {
+            if (file) {
+                std::fclose(file);
+            }
+        }
+
+        // Appends a job start record to the file. A file with another format or a torn last record
+        // is rotated away first.
+        bool open() {
+            std::lock_guard<std::mutex> lock(mutex);
+            StatFileHeader header;
+            if (std::FILE* current = std::fopen(path.c_str(), "rb")) {
+                bool valid = std::fread(&header, sizeof(header), 1, current) == 1 && validStatHeader(header);
+                long complete = static_cast<long>(sizeof(header));
+                StatRecord record;
+                while (valid && readStatRecord(current, record)) {
+                    complete = std::ftell(current);
+                }
+                std::fseek(current, 0, SEEK_END);
+                long existing = std::ftell(current);
+                std::fclose(current);
+                if (existing > 0 && (!valid || complete != existing)) {
+                    std::rename(path.c_str(), (path + ".1").c_str());
+                }
+            }
+            if (!openFile()) {
+                return false;
+            }
+            append(makeRecord(statJobStart));
+            return file != nullptr;
+        }
+
+        // Per-worker counters handed to the engine (EngineContext::workerHashes).
+        WorkerCounter* workerHashes() { return workers > 0 ? counters.get() : nullptr; }
+
+        // One per-second sample; `elapsed` is the time since the previous one.
+        void sample(double hashRate, double elapsed) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished || !file) {
+                return;
+            }
+            StatRecord record = makeRecord(statSample);
+            record.hashRate = static_cast<float>(hashRate);
+            record.workers = static_cast<std::uint32_t>(workers);
+            record.workerRates.resize(workers);
+            for (int w = 0; w < workers; ++w) {
+                std::uint64_t hashes = counters[w].hashes.load(std::memory_order_relaxed);
+                record.workerRates[w] = static_cast<float>((hashes - last[w]) / std::max(elapsed, 1e-3));
+                last[w] = hashes;
+            }
+            append(record);
+        }
+
+        // Closes the job with an event record; samples after it are dropped.
+        void finish(bool hit, int zeros) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished || !file) {
+                return;
+            }
+            StatRecord record = makeRecord(statJobEnd | (hit ? statHit : 0));
+            record.zeros = static_cast<std::uint8_t>(hit ? zeros : 0);
+            append(record);
+            finished = true;
+        }
+
+    private:
+        std::mutex mutex;
+        std::string path;
+        std::uint64_t maxBytes;
+        std::uint32_t block;
+        int workers;
+        std::shared_ptr<WorkerGate> gate;
+        std::unique_ptr<WorkerCounter[]> counters;
+        std::vector<std::uint64_t> last;
+        CpuSensors sensors;
+        std::FILE* file = nullptr;
+        std::uint64_t size = 0;
+        bool finished = false;
+
+        bool openFile() {
+            file = std::fopen(path.c_str(), "ab");
+            if (!file) {
+                return false;
+            }
+            std::fseek(file, 0, SEEK_END);
+            size = static_cast<std::uint64_t>(std::ftell(file));
+            if (size == 0) {
+                StatFileHeader header;
+                std::memcpy(header.magic, statMagic, sizeof(statMagic));
+                header.version = statVersion;
+                header.recordSize = sizeof(StatRecordHead);
+                if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+                    return fail();
+                }
+                size = sizeof(header);
+            }
+            return true;
+        }
+
+        StatRecord makeRecord(std::uint16_t events) const {
+            StatRecord record;
+            static_cast<StatRecordHead&>(record) = {};
+            record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.temperature = static_cast<float>(sensors.temperature());
+            record.frequency = static_cast<float>(sensors.frequency());
+            record.block = block;
+            record.events = events | (workers == 0 ? statGpu : 0);
+            record.active = static_cast<std::uint32_t>(gate ? gate->active.load() : workers);
+            record.duty = static_cast<std::uint8_t>(gate ? gate->duty.load() : 100);
+            return record;
+        }
+
+        // Flushed every record so a killed miner loses at most the current second.
+        void append(const StatRecord& record) {
+            std::uint64_t bytes = sizeof(StatRecordHead) + record.workerRates.size() * sizeof(float);
+            if (size + bytes > maxBytes) {
+                std::fclose(file);
+                file = nullptr;
+                std::rename(path.c_str(), (path + ".1").c_str());
+                if (!openFile()) {
+                    return;
+                }
+            }
+            if (std::fwrite(static_cast<const StatRecordHead*>(&record), sizeof(StatRecordHead), 1, file) != 1
+                || std::fwrite(record.workerRates.data(), sizeof(float), record.workerRates.size(), file) != record.workerRates.size()
+                || std::fflush(file) != 0) {
+                fail();
+                return;
+            }
+            size += bytes;
+        }
+
+        bool fail() {
+            std::cerr << "[REC] Cannot write " << path << ", recording stopped." << std::endl;
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+};
+
+// Records of <path>.1 then <path>, oldest first; a torn last record is ignored.
+inline bool readStatRecords(const std::string& path, std::vector<StatRecord>& records) {
+    bool any = false;
+    for (const std::string& name : {path + ".1", path}) {
+        std::FILE* file = std::fopen(name.c_str(), "rb");
+        if (!file) {
+            continue;
+        }
+        StatFileHeader header;
+        if (std::fread(&header, sizeof(header), 1, file) == 1 && validStatHeader(header)) {
+            StatRecord record;
+            while (readStatRecord(file, record)) {
+                records.push_back(record);
+            }
+            any = true;
+        } else {
+            std::cerr << name << " is not a recorder file." << std::endl;
+        }
+        std::fclose(file);
+    }
+    return any;
+}
+
+inline std::string formatStatTime(std::int64_t time) {
+    std::time_t seconds = static_cast<std::time_t>(time / 1000);
+    std::ostringstream text;
+    text << std::put_time(std::gmtime(&seconds), "%Y-%m-%d %H:%M:%S") << "Z";
+    return text.str();
+}
+
+inline std::string statEventNames(std::uint16_t events) {
+    static const char* names[] = {"sample", "start", "end", "hit", "gpu"};
+    std::string text;
+    for (int bit = 0; bit < 5; ++bit) {
+        if (events & (1 << bit)) {
+            text += (text.empty() ? "" : "+") + std::string(names[bit]);
+        }
+    }
+    return text;
+}
+
+inline void writeStatCsv(const std::vector<StatRecord>& records, std::ostream& out) {
+    int workers = 0;
+    for (const auto& record : records) {
+        workers = std::max<int>(workers, record.workers);
+    }
+    out << "time,utc,events,block,hashRate,active,duty,temperature,frequency,zeros";
+    for (int w = 0; w < workers; ++w) {
+        out << ",worker" << w;
+    }
+    out << "\n";
+    for (const auto& record : records) {
+        out << record.time << "," << formatStatTime(record.time) << "," << statEventNames(record.events) << "," << record.block
+            << "," << std::fixed << std::setprecision(0) << record.hashRate << "," << static_cast<int>(record.active)
+            << "," << static_cast<int>(record.duty) << "," << std::setprecision(1) << record.temperature
+            << "," << std::setprecision(3) << record.frequency << "," << static_cast<int>(record.zeros);
+        for (int w = 0; w < workers; ++w) {
+            out << ",";
+            if (w < static_cast<int>(record.workers)) {
+                out << std::setprecision(0) << record.workerRates[w];
+            }
+        }
+        out << "\n";
+    }
+}
+
+// Human summary: rate distribution, dips (below 80% of the median) against temperature and
+// frequency, throttling, per-worker rates, gaps in the series and job latencies.
+inline void writeStatReport(const std::vector<StatRecord>& records, std::ostream& out) {
+    std::vector<const StatRecord*> samples;
+    for (const auto& record : records) {
+        if (record.events & statSample) {
+            samples.push_back(&record);
+        }
+    }
+    out << "[REPORT] " << records.size() << " records, " << samples.size() << " samples";
+    if (!records.empty()) {
+        out << ", " << formatStatTime(records.front().time) << " to " << formatStatTime(records.back().time);
+    }
+    out << "\n";
+
+    // Jobs run from a start event to an end event; a start without an end was killed or replaced.
+    int jobs = 0, hits = 0, misses = 0, gaps = 0;
+    double latencyTotal = 0, latencyMax = 0, missing = 0;
+    bool open = false;
+    std::int64_t jobStart = 0, previous = 0;
+    std::uint32_t slowestBlock = 0;
+    for (const auto& record : records) {
+        if (record.events & statJobStart) {
+            open = true;
+            ++jobs;
+            jobStart = record.time;
+        } else if (open && (record.events & statSample) && record.time - previous > 2000) {
+            ++gaps;
+            missing += (record.time - previous) / 1000.0 - 1;
+        }
+        if (open && (record.events & statJobEnd)) {
+            open = false;
+            misses += (record.events & statHit) ? 0 : 1;
+            if (record.events & statHit) {
+                double latency = (record.time - jobStart) / 1000.0;
+                ++hits;
+                latencyTotal += latency;
+                if (latency >= latencyMax) {
+                    latencyMax = latency;
+                    slowestBlock = record.block;
+                }
+            }
+        }
+        previous = record.time;
+    }
+    out << std::fixed << std::setprecision(1);
+    out << "[REPORT] Jobs: " << jobs << ", hits: " << hits << ", ended without a hit: " << misses
+        << ", killed or running: " << jobs - hits - misses;
+    if (hits > 0) {
+        out << ", time to hit: mean " << latencyTotal / hits << " s, max " << latencyMax << " s (block " << slowestBlock << ")";
+    }
+    out << "\n[REPORT] Gaps: " << gaps << " (" << missing << " s missing)\n";
+    if (samples.empty()) {
+        return;
+    }
+
+    std::vector<double> rates;
+    double total = 0, temperatureTotal = 0, temperatureMax = 0, frequencyTotal = 0, frequencyMax = 0, frequencyMin = 0;
+    for (const auto* sample : samples) {
+        rates.push_back(sample->hashRate);
+        total += sample->hashRate;
+        temperatureTotal += sample->temperature;
+        temperatureMax = std::max<double>(temperatureMax, sample->temperature);
+        frequencyTotal += sample->frequency;
+        frequencyMax = std::max<double>(frequencyMax, sample->frequency);
+        frequencyMin = frequencyMin == 0 ? sample->frequency : std::min<double>(frequencyMin, sample->frequency);
+    }
+    std::sort(rates.begin(), rates.end());
+    double median = rates[rates.size() / 2];
+    auto percentile = [&](double p) { return rates[static_cast<size_t>(p * (rates.size() - 1))]; };
+    out << "[REPORT] Hash rate: mean " << formatHashRate(total / samples.size()) << ", median " << formatHashRate(median)
+        << ", p5 " << formatHashRate(percentile(0.05)) << ", min " << formatHashRate(rates.front())
+        << ", max " << formatHashRate(rates.back()) << "\n";
+
+    int dips = 0, run = 0, longest = 0, throttled = 0;
+    std::int64_t longestAt = 0;
+    double dipTemperature = 0, dipFrequency = 0;
+    for (const auto* sample : samples) {
+        throttled += frequencyMax > 0 && sample->frequency < frequencyMax * 0.9 ? 1 : 0;
+        if (sample->hashRate < median * 0.8) {
+            ++dips;
+            dipTemperature += sample->temperature;
+            dipFrequency += sample->frequency;
+            if (++run > longest) {
+                longest = run;
+                longestAt = sample->time;
+            }
+        } else {
+            run = 0;
+        }
+    }
+    out << "[REPORT] Dips below 80% of median: " << dips << " s";
+    if (dips > 0) {
+        out << ", longest " << longest << " s ending " << formatStatTime(longestAt);
+        if (temperatureMax > 0) {
+            out << ", temp " << dipTemperature / dips << "C vs " << temperatureTotal / samples.size() << "C overall";
+        }
+        if (frequencyMax > 0) {
+            out << std::setprecision(2) << ", freq " << dipFrequency / dips << " GHz vs " << frequencyTotal / samples.size() << " GHz";
+        }
+    }
+    out << "\n" << std::setprecision(1);
+    if (temperatureMax > 0) {
+        out << "[REPORT] Temperature: mean " << temperatureTotal / samples.size() << "C, max " << temperatureMax << "C\n";
+    }
+    if (frequencyMax > 0) {
+        out << std::setprecision(2) << "[REPORT] Frequency: mean " << frequencyTotal / samples.size() << " GHz, min " << frequencyMin
+            << " GHz, max " << frequencyMax << " GHz, below 90% of max: " << throttled << " s\n";
+    }
+
+    std::vector<double> workerTotal;
+    std::vector<int> workerSamples;
+    for (const auto* sample : samples) {
+        workerTotal.resize(std::max<size_t>(workerTotal.size(), sample->workers), 0);
+        workerSamples.resize(workerTotal.size(), 0);
+        for (std::uint32_t w = 0; w < sample->workers; ++w) {
+            workerTotal[w] += sample->workerRates[w];
+            ++workerSamples[w];
+        }
+    }
+    for (size_t w = 0; w < workerTotal.size(); ++w) {
+        out << "[REPORT] Worker " << w << ": mean " << formatHashRate(workerTotal[w] / workerSamples[w]) << "\n";
+    }
+}
@@ -0,0 +1,124 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Thermal governor for sustained throughput. Holds the hottest CPU thermal zone at a setpoint
+    by integrating the temperature error into a power level (workers x duty cycle): level 2.5 of
+    4 workers runs 3 workers at 83%. A slow integral keeps the rig just under its throttling
+    point for the whole block instead of boosting and then oscillating. Linux sysfs only.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "affinity.h"
+
+// Hottest CPU thermal zone and mean core frequency from Linux sysfs. Shared by the governor and
+// the recorder (recorder.h).
+class CpuSensors {
+    public:
+        explicit CpuSensors(const std::string& sysfs = "/sys") {
+            // CPU package/SoC zones when the platform names them, otherwise every zone.
+            std::vector<std::string> all;
+            for (int zone = 0; zone < 64; ++zone) {
+                std::string base = sysfs + "/class/thermal/thermal_zone" + std::to_string(zone) + "/";
+                std::string type = readFirstLine(base + "type");
+                if (type.empty()) {
+                    continue;
+                }
+                all.push_back(base + "temp");
+                if (type.find("cpu") != std::string::npos || type.find("pkg") != std::string::npos
+                    || type.find("soc") != std::string::npos || type.find("core") != std::string::npos) {
+                    zones.push_back(base + "temp");
+                }
+            }
+            if (zones.empty()) {
+                zones = all;
+            }
+            for (int cpu : cpuTopology().compact) {
+                std::string path = sysfs + "/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq";
+                if (!readFirstLine(path).empty()) {
+                    frequencies.push_back(path);
+                }
+            }
+        }
+
+        bool hasTemperature() const { return !zones.empty(); }
+        bool hasFrequency() const { return !frequencies.empty(); }
+
+        // Celsius, 0 without thermal zones.
+        double temperature() const {
+            double temperature = 0;
+            for (const auto& zone : zones) {
+                temperature = std::max(temperature, readNumber(zone) / 1000.0);
+            }
+            return temperature;
+        }
+
+        // GHz, 0 without cpufreq.
+        double frequency() const {
+            double total = 0;
+            for (const auto& frequency : frequencies) {
+                total += readNumber(frequency);
+            }
+            return frequencies.empty() ? 0 : total / frequencies.size() / 1e6;
+        }
+
+    private:
+        std::vector<std::string> zones;
+        std::vector<std::string> frequencies;
+
+        static double readNumber(const std::string& path) {
+            try {
+                return std::stod(readFirstLine(path));
+            } catch (const std::exception&) {
+                return 0;
+            }
+        }
+};
+
+class ThermalGovernor : public Governor {
+    public:
+        ThermalGovernor(std::shared_ptr<WorkerGate> gate, int maxWorkers, double setpoint, const std::string& sysfs = "/sys")
+            : gate(std::move(gate)), maxWorkers(maxWorkers), setpoint(setpoint), level(maxWorkers), sensors(sysfs) {}
+
+        bool available() const { return sensors.hasTemperature(); }
+
+        std::string step() override {
+            double temperature = sensors.temperature();
+            // Integral step: a tenth of the workers per second for every 10 degrees of error.
+            level += (setpoint - temperature) * maxWorkers * 0.01;
+            level = std::min<double>(std::max(level, minLevel), maxWorkers);
+            int workers = static_cast<int>(std::ceil(level - 1e-9));
+            gate->duty.store(static_cast<int>(std::lround(level / workers * 100)));
+            gate->setLimit(WorkerGate::thermalLimit, workers);
+
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "temp " << temperature << "C (target " << setpoint
+                 << "C) workers " << gate->active.load() << "/" << maxWorkers << " duty " << gate->duty.load() << "%";
+            if (sensors.hasFrequency()) {
+                line << std::setprecision(2) << " freq " << sensors.frequency() << " GHz";
+            }
+            return line.str();
+        }
+
+    private:
+        static constexpr double minLevel = 0.25;
+        std::shared_ptr<WorkerGate> gate;
+        int maxWorkers;
+        double setpoint;
+        double level;
+        CpuSensors sensors;
+};
@@ -0,0 +1,88 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Ranking by leading zero nibbles with ties broken by value is the same as ranking by
+// the hash as a big-endian number, so candidates are simply ordered by memcmp.
+struct Candidate {
+    std::array<std::uint8_t, 32> hash;
+    std::uint64_t nonce;
+
+    bool operator<(const Candidate& other) const {
+        int cmp = std::memcmp(hash.data(), other.hash.data(), hash.size());
+        return cmp < 0 || (cmp == 0 && nonce < other.nonce);
+    }
+};
+
+// Bounded heap of the K best hashes, weakest candidate at the root. Each worker owns one
+// (no locks on the hashing path) and they are merged once the worker is done.
+class TopK {
+    public:
+        explicit TopK(size_t k = 0) : k(k) { heap.reserve(k); }
+
+        size_t capacity() const { return k; }
+
+        // Cheap rejection on the first 8 bytes; most hashes never get past this.
+        bool admits(const std::uint8_t* hash) const {
+            return heap.size() < k || prefix(hash) <= threshold;
+        }
+
+        void push(const std::uint8_t* hash, std::uint64_t nonce) {
+            if (k == 0) {
+                return;
+            }
+            Candidate candidate;
+            std::memcpy(candidate.hash.data(), hash, candidate.hash.size());
+            candidate.nonce = nonce;
+            if (heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            } else {
+                return;
+            }
+            if (heap.size() == k) {
+                threshold = prefix(heap.front().hash.data());
+            }
+        }
+
+        void merge(const TopK& other) {
+            for (const auto& candidate : other.heap) {
+                push(candidate.hash.data(), candidate.nonce);
+            }
+        }
+
+        std::vector<Candidate> sorted() const {
+            std::vector<Candidate> result(heap);
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+    private:
+        size_t k;
+        std::uint64_t threshold = ~0ULL;
+        std::vector<Candidate> heap;
+
+        static std::uint64_t prefix(const std::uint8_t* hash) {
+            std::uint64_t value = 0;
+            for (int i = 0; i < 8; ++i) {
+                value = (value << 8) | hash[i];
+            }
+            return value;
+        }
+};
@@ -0,0 +1,407 @@
+/*
+    MIT License
+    Author: Fred Kyung-jin Rezeau <fred@litemint.com>, 2025
+    Permission is granted to use, copy, modify, and distribute this software for any purpose
+    with or without fee.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+
+    Vulkan compute backend running utils/keccak.spv. Instance, device, pipeline, descriptors and
+    buffers are created on the first batch and reused for the whole run. Each batch is split
+    into chunks submitted asynchronously with two command buffers in flight, and the found flag
+    is checked in host-coherent memory as each chunk retires. Any Vulkan 1.1 device with
+    shaderInt64 works, including Mesa's lavapipe software device.
+*/
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#define VK_CALL(call)                                                               \
+    do {                                                                            \
+        VkResult res = call;                                                        \
+        if (res != VK_SUCCESS) {                                                    \
+            std::cout << "Vulkan Error in " << __FILE__ << ", line " << __LINE__    \
+                      << ": Error Code " << res << std::endl;                       \
+            exit(EXIT_FAILURE);                                                     \
+        }                                                                           \
+    } while (0)
+
+namespace {
+
+const std::uint32_t rate = 136;
+const std::uint32_t maxBlocks = 2;  // 256-byte messages, as the OpenCL kernel.
+const int slots = 2;
+const int chunksPerBatch = 8;
+
+struct PushConstants {
+    std::uint64_t startNonce;
+    std::uint64_t batchSize;
+    std::uint32_t blocks;
+    std::uint32_t nonceOffset;
+    std::int32_t difficulty;
+};
+
+struct SearchResult {
+    std::uint32_t found;
+    std::uint32_t reserved;
+    std::uint64_t nonce;
+    std::uint64_t hash[4];
+};
+
+struct VulkanState {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkBuffer buffers[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    VkDeviceMemory memory[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    void* mapped[2] = {nullptr, nullptr};
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commands[slots] = {};
+    VkFence fences[slots] = {};
+    std::uint32_t workGroupSize = 0;
+    std::uint32_t maxGroups = 0;
+};
+
+std::vector<std::uint32_t> loadShader(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::uint32_t> code(bytes.size() / 4);
+    std::memcpy(code.data(), bytes.data(), code.size() * 4);
+    return code;
+}
+
+bool createBuffer(VulkanState& vk, int index, VkDeviceSize size) {
+    VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VK_CALL(vkCreateBuffer(vk.device, &bufferInfo, nullptr, &vk.buffers[index]));
+
+    // Host-visible coherent memory: the message is tiny and the result is polled by the host.
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(vk.device, vk.buffers[index], &requirements);
+    VkPhysicalDeviceMemoryProperties properties;
+    vkGetPhysicalDeviceMemoryProperties(vk.physicalDevice, &properties);
+    VkMemoryPropertyFlags wanted = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for (std::uint32_t type = 0; type < properties.memoryTypeCount; ++type) {
+        if ((requirements.memoryTypeBits & (1u << type)) && (properties.memoryTypes[type].propertyFlags & wanted) == wanted) {
+            VkMemoryAllocateInfo allocInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+            allocInfo.allocationSize = requirements.size;
+            allocInfo.memoryTypeIndex = type;
+            VK_CALL(vkAllocateMemory(vk.device, &allocInfo, nullptr, &vk.memory[index]));
+            VK_CALL(vkBindBufferMemory(vk.device, vk.buffers[index], vk.memory[index], 0));
+            VK_CALL(vkMapMemory(vk.device, vk.memory[index], 0, VK_WHOLE_SIZE, 0, &vk.mapped[index]));
+            return true;
+        }
+    }
+    std::cerr << "No host-visible coherent memory type for Vulkan buffers." << std::endl;
+    return false;
+}
+
+// Physical devices with shaderInt64, in enumeration order. `--device` indexes this list, and the
+// plugin probe counts it, so both agree on which devices exist.
+std::vector<VkPhysicalDevice> usableDevices(VkInstance instance) {
+    std::uint32_t deviceCount = 0;
+    std::vector<VkPhysicalDevice> devices;
+    if (vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr) == VK_SUCCESS) {
+        devices.resize(deviceCount);
+        vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+        devices.resize(deviceCount);
+    }
+    std::vector<VkPhysicalDevice> usable;
+    for (VkPhysicalDevice device : devices) {
+        VkPhysicalDeviceFeatures features;
+        vkGetPhysicalDeviceFeatures(device, &features);
+        if (features.shaderInt64) {
+            usable.push_back(device);
+        }
+    }
+    return usable;
+}
+
+// Creates the persistent objects on first use; returns nullptr when no usable device exists.
+VulkanState* initVulkan(int deviceId, int threadsPerBlock, bool showDeviceInfo) {
+    static VulkanState vk;
+    static bool initialized = false;
+    if (initialized) {
+        return vk.pipeline ? &vk : nullptr;
+    }
+    initialized = true;
+
+    VkApplicationInfo appInfo{VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    appInfo.pApplicationName = "kale-miner";
+    appInfo.apiVersion = VK_API_VERSION_1_1;
+    VkInstanceCreateInfo instanceInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    instanceInfo.pApplicationInfo = &appInfo;
+    if (vkCreateInstance(&instanceInfo, nullptr, &vk.instance) != VK_SUCCESS) {
+        std::cerr << "Failed to create Vulkan instance (is a Vulkan driver installed?)." << std::endl;
+        return nullptr;
+    }
+
+    std::vector<VkPhysicalDevice> devices = usableDevices(vk.instance);
+    std::cout << "Vulkan devices (with shaderInt64):" << std::endl;
+    for (size_t i = 0; i < devices.size(); ++i) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(devices[i], &properties);
+        std::cout << "    [" << (static_cast<int>(i) == deviceId ? "X" : " ") << "] " << properties.deviceName << std::endl;
+    }
+    if (devices.empty()) {
+        std::cerr << "No Vulkan device supports shaderInt64." << std::endl;
+        return nullptr;
+    }
+    if (deviceId < 0 || deviceId >= static_cast<int>(devices.size())) {
+        std::cerr << "Invalid device ID" << std::endl;
+        return nullptr;
+    }
+    vk.physicalDevice = devices[deviceId];
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(vk.physicalDevice, &properties);
+    vk.workGroupSize = std::max<std::uint32_t>(1, std::min<std::uint32_t>({static_cast<std::uint32_t>(threadsPerBlock),
+        properties.limits.maxComputeWorkGroupSize[0], properties.limits.maxComputeWorkGroupInvocations}));
+    vk.maxGroups = properties.limits.maxComputeWorkGroupCount[0];
+    if (showDeviceInfo) {
+        std::cout << "Device: " << properties.deviceName << " (Vulkan " << VK_VERSION_MAJOR(properties.apiVersion) << "."
+                  << VK_VERSION_MINOR(properties.apiVersion) << "." << VK_VERSION_PATCH(properties.apiVersion) << ")" << std::endl;
+        std::cout << "Max work group size: " << properties.limits.maxComputeWorkGroupInvocations << std::endl;
+        std::cout << "Work group size: " << vk.workGroupSize << std::endl;
+    }
+
+    std::uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(vk.physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(vk.physicalDevice, &familyCount, families.data());
+    std::uint32_t family = familyCount;
+    for (std::uint32_t i = 0; i < familyCount && family == familyCount; ++i) {
+        if (families[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+            family = i;
+        }
+    }
+    if (family == familyCount) {
+        std::cerr << "Vulkan device has no compute queue." << std::endl;
+        return nullptr;
+    }
+
+    float priority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+    queueInfo.queueFamilyIndex = family;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+    VkPhysicalDeviceFeatures enabled{};
+    enabled.shaderInt64 = VK_TRUE;
+    VkDeviceCreateInfo deviceInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    deviceInfo.pEnabledFeatures = &enabled;
+    VK_CALL(vkCreateDevice(vk.physicalDevice, &deviceInfo, nullptr, &vk.device));
+    vkGetDeviceQueue(vk.device, family, 0, &vk.queue);
+
+    if (!createBuffer(vk, 0, maxBlocks * rate) || !createBuffer(vk, 1, sizeof(SearchResult))) {
+        return nullptr;
+    }
+
+    std::vector<std::uint32_t> code = loadShader("utils/keccak.spv");
+    if (code.empty()) {
+        std::cerr << "Failed to load Vulkan shader utils/keccak.spv." << std::endl;
+        return nullptr;
+    }
+    VkShaderModuleCreateInfo moduleInfo{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+    moduleInfo.codeSize = code.size() * 4;
+    moduleInfo.pCode = code.data();
+    VkShaderModule shader;
+    VK_CALL(vkCreateShaderModule(vk.device, &moduleInfo, nullptr, &shader));
+
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    for (std::uint32_t i = 0; i < 2; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    setLayoutInfo.bindingCount = 2;
+    setLayoutInfo.pBindings = bindings;
+    VK_CALL(vkCreateDescriptorSetLayout(vk.device, &setLayoutInfo, nullptr, &vk.setLayout));
+
+    VkPushConstantRange pushRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants)};
+    VkPipelineLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &vk.setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    VK_CALL(vkCreatePipelineLayout(vk.device, &layoutInfo, nullptr, &vk.pipelineLayout));
+
+    // local_size_x is specialization constant 0.
+    VkSpecializationMapEntry entry{0, 0, sizeof(std::uint32_t)};
+    VkSpecializationInfo specialization{1, &entry, sizeof(std::uint32_t), &vk.workGroupSize};
+    VkComputePipelineCreateInfo pipelineInfo{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shader;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = &specialization;
+    pipelineInfo.layout = vk.pipelineLayout;
+    VkPipeline pipeline;
+    VK_CALL(vkCreateComputePipelines(vk.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline));
+    vkDestroyShaderModule(vk.device, shader, nullptr);
+
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2};
+    VkDescriptorPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VK_CALL(vkCreateDescriptorPool(vk.device, &poolInfo, nullptr, &vk.descriptorPool));
+    VkDescriptorSetAllocateInfo setInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    setInfo.descriptorPool = vk.descriptorPool;
+    setInfo.descriptorSetCount = 1;
+    setInfo.pSetLayouts = &vk.setLayout;
+    VK_CALL(vkAllocateDescriptorSets(vk.device, &setInfo, &vk.descriptorSet));
+    VkDescriptorBufferInfo bufferInfos[2];
+    VkWriteDescriptorSet writes[2];
+    for (std::uint32_t i = 0; i < 2; ++i) {
+        bufferInfos[i] = {vk.buffers[i], 0, VK_WHOLE_SIZE};
+        writes[i] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        writes[i].dstSet = vk.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(vk.device, 2, writes, 0, nullptr);
+
+    VkCommandPoolCreateInfo commandPoolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    commandPoolInfo.queueFamilyIndex = family;
+    VK_CALL(vkCreateCommandPool(vk.device, &commandPoolInfo, nullptr, &vk.commandPool));
+    VkCommandBufferAllocateInfo commandInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    commandInfo.commandPool = vk.commandPool;
+    commandInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandInfo.commandBufferCount = slots;
+    VK_CALL(vkAllocateCommandBuffers(vk.device, &commandInfo, vk.commands));
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    for (int i = 0; i < slots; ++i) {
+        VK_CALL(vkCreateFence(vk.device, &fenceInfo, nullptr, &vk.fences[i]));
+    }
+    vk.pipeline = pipeline;
+    return &vk;
+}
+
+void submitChunk(VulkanState& vk, int slot, const PushConstants& params) {
+    VkCommandBuffer command = vk.commands[slot];
+    VK_CALL(vkResetCommandBuffer(command, 0));
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CALL(vkBeginCommandBuffer(command, &beginInfo));
+    vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, vk.pipeline);
+    vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_COMPUTE, vk.pipelineLayout, 0, 1, &vk.descriptorSet, 0, nullptr);
+    vkCmdPushConstants(command, vk.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    std::uint64_t groups = (params.batchSize + vk.workGroupSize - 1) / vk.workGroupSize;
+    vkCmdDispatch(command, static_cast<std::uint32_t>(std::min<std::uint64_t>(std::max<std::uint64_t>(groups, 1), vk.maxGroups)), 1, 1);
+    VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    VK_CALL(vkEndCommandBuffer(command));
+
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &command;
+    VK_CALL(vkQueueSubmit(vk.queue, 1, &submitInfo, vk.fences[slot]));
+}
+
+void waitChunk(VulkanState& vk, int slot) {
+    VK_CALL(vkWaitForFences(vk.device, 1, &vk.fences[slot], VK_TRUE, UINT64_MAX));
+    VK_CALL(vkResetFences(vk.device, 1, &vk.fences[slot]));
+}
+
+}
+
+extern "C" int executeKernel(int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset, std::uint64_t batchSize,
+    int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo) {
+    VulkanState* vk = initVulkan(deviceId, threadsPerBlock, showDeviceInfo);
+    if (!vk) {
+        return -1;
+    }
+    std::uint32_t blocks = static_cast<std::uint32_t>(dataSize) / rate + 1;
+    if (blocks > maxBlocks || nonceOffset < 0 || nonceOffset + 8 > dataSize) {
+        std::cerr << "Unsupported message layout for the Vulkan kernel." << std::endl;
+        return -1;
+    }
+
+    // Padded message with the nonce zeroed; no chunk is in flight between batches.
+    std::uint8_t* message = static_cast<std::uint8_t*>(vk->mapped[0]);
+    std::memset(message, 0, maxBlocks * rate);
+    std::memcpy(message, data, dataSize);
+    std::memset(message + nonceOffset, 0, 8);
+    message[dataSize] ^= 0x01;
+    message[blocks * rate - 1] ^= 0x80;
+    volatile SearchResult* result = static_cast<volatile SearchResult*>(vk->mapped[1]);
+    result->found = 0;
+
+    std::uint64_t chunk = std::max<std::uint64_t>(1, (batchSize + chunksPerBatch - 1) / chunksPerBatch);
+    bool pending[slots] = {};
+    std::uint64_t offset = 0;
+    for (int slot = 0; offset < batchSize && result->found == 0; slot = (slot + 1) % slots) {
+        if (pending[slot]) {
+            waitChunk(*vk, slot);
+            pending[slot] = false;
+            if (result->found != 0) {
+                break;
+            }
+        }
+        PushConstants params{startNonce + offset, std::min(chunk, batchSize - offset), blocks,
+            static_cast<std::uint32_t>(nonceOffset), difficulty};
+        submitChunk(*vk, slot, params);
+        pending[slot] = true;
+        offset += params.batchSize;
+    }
+    for (int slot = 0; slot < slots; ++slot) {
+        if (pending[slot]) {
+            waitChunk(*vk, slot);
+        }
+    }
+
+    int found = static_cast<int>(result->found);
+    if (found == 1) {
+        *validNonce = result->nonce;
+        for (int i = 0; i < 32; ++i) {
+            output[i] = static_cast<std::uint8_t>(result->hash[i / 8] >> (8 * (i % 8)));
+        }
+    }
+    return found;
+}
+
+// Runtime-loaded backend entry points (make plugins, see utils/backend.h).
+// The probe counts usable devices (see usableDevices) on a throwaway instance and never exits.
+extern "C" int kaleBackendProbe(const char*) {
+    VkApplicationInfo appInfo{VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    appInfo.pApplicationName = "kale-miner";
+    appInfo.apiVersion = VK_API_VERSION_1_1;
+    VkInstanceCreateInfo instanceInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    instanceInfo.pApplicationInfo = &appInfo;
+    VkInstance instance;
+    if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS) {
+        return 0;
+    }
+    int usable = static_cast<int>(usableDevices(instance).size());
+    vkDestroyInstance(instance, nullptr);
+    return usable;
+}
+
+extern "C" int kaleBackendExecute(const char*, int deviceId, std::uint8_t* data, int dataSize, std::uint64_t startNonce, int nonceOffset,
+    std::uint64_t batchSize, int difficulty, int threadsPerBlock, std::uint8_t* output, std::uint64_t* validNonce, bool showDeviceInfo) {
+    return executeKernel(deviceId, data, dataSize, startNonce, nonceOffset, batchSize, difficulty, threadsPerBlock,
+        output, validNonce, showDeviceInfo);
+}